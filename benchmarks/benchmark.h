@@ -0,0 +1,77 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <time.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+/**
+ * Minimal helpers shared by the benchmarks, not part of the library.
+ */
+
+/**
+ * Prevents the compiler from optimizing away the computation of value.
+ */
+#define Benchmark_keep(value) \
+    __asm__ __volatile__("" : : "g"(value) : "memory")
+
+/**
+ * Runs body iterations times and prints the elapsed time per iteration.
+ */
+#define Benchmark_run(name, iterations, ...)                                        \
+    do {                                                                            \
+        const size_t __iterations = (iterations);                                   \
+        const uint64_t __start = Benchmark_now();                                   \
+        for (size_t __i = 0; __i < __iterations; __i++) {                           \
+            __VA_ARGS__;                                                            \
+        }                                                                           \
+        Benchmark_report((name), __iterations, Benchmark_now() - __start);          \
+    } while (0)
+
+/**
+ * Returns a monotonic timestamp in nanoseconds.
+ */
+static inline uint64_t Benchmark_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+/**
+ * Prints the time per iteration of a benchmark.
+ */
+static inline void Benchmark_report(const char *const name, const size_t iterations, const uint64_t elapsed) {
+    printf("%-40s %12.3f ns/op %12.3f ms total\n",
+           name, (double) elapsed / (double) (iterations ? iterations : 1), (double) elapsed / 1e6);
+}
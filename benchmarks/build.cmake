@@ -0,0 +1,38 @@
+set(BENCHMARK_OPTIONS -O2)
+
+add_executable(benchmark-option-some ${CMAKE_CURRENT_LIST_DIR}/benchmark.h ${CMAKE_CURRENT_LIST_DIR}/option-some.c)
+target_compile_options(benchmark-option-some PRIVATE ${BENCHMARK_OPTIONS})
+target_link_libraries(benchmark-option-some PRIVATE option panic)
+
+add_executable(benchmark-option-batch ${CMAKE_CURRENT_LIST_DIR}/benchmark.h ${CMAKE_CURRENT_LIST_DIR}/option-batch.c)
+target_compile_options(benchmark-option-batch PRIVATE ${BENCHMARK_OPTIONS})
+target_link_libraries(benchmark-option-batch PRIVATE option)
+
+add_executable(benchmark-call-sites ${CMAKE_CURRENT_LIST_DIR}/benchmark.h ${CMAKE_CURRENT_LIST_DIR}/call-sites.c)
+target_compile_options(benchmark-call-sites PRIVATE ${BENCHMARK_OPTIONS})
+target_link_libraries(benchmark-call-sites PRIVATE option)
+
+add_executable(benchmark-call-sites-table ${CMAKE_CURRENT_LIST_DIR}/benchmark.h ${CMAKE_CURRENT_LIST_DIR}/call-sites.c)
+target_compile_definitions(benchmark-call-sites-table PRIVATE OPTION_CALL_SITES)
+target_compile_options(benchmark-call-sites-table PRIVATE ${BENCHMARK_OPTIONS})
+target_link_libraries(benchmark-call-sites-table PRIVATE option)
+
+add_executable(benchmark-option-hpp ${CMAKE_CURRENT_LIST_DIR}/benchmark.h ${CMAKE_CURRENT_LIST_DIR}/option-hpp.cpp)
+target_compile_options(benchmark-option-hpp PRIVATE ${BENCHMARK_OPTIONS})
+target_link_libraries(benchmark-option-hpp PRIVATE panic)
+
+add_executable(benchmark-option-parallel ${CMAKE_CURRENT_LIST_DIR}/benchmark.h ${CMAKE_CURRENT_LIST_DIR}/option-parallel.c)
+target_compile_options(benchmark-option-parallel PRIVATE ${BENCHMARK_OPTIONS})
+target_link_libraries(benchmark-option-parallel PRIVATE option panic)
+
+add_executable(benchmark-option-promise ${CMAKE_CURRENT_LIST_DIR}/benchmark.h ${CMAKE_CURRENT_LIST_DIR}/option-promise.c)
+target_compile_options(benchmark-option-promise PRIVATE ${BENCHMARK_OPTIONS})
+target_link_libraries(benchmark-option-promise PRIVATE option panic)
+
+add_executable(benchmark-option-rcu ${CMAKE_CURRENT_LIST_DIR}/benchmark.h ${CMAKE_CURRENT_LIST_DIR}/option-rcu.c)
+target_compile_options(benchmark-option-rcu PRIVATE ${BENCHMARK_OPTIONS})
+target_link_libraries(benchmark-option-rcu PRIVATE option panic)
+
+add_executable(benchmark-option-iterator ${CMAKE_CURRENT_LIST_DIR}/benchmark.h ${CMAKE_CURRENT_LIST_DIR}/option-iterator.c)
+target_compile_options(benchmark-option-iterator PRIVATE ${BENCHMARK_OPTIONS})
+target_link_libraries(benchmark-option-iterator PRIVATE option)
@@ -0,0 +1,42 @@
+#!/usr/bin/env bash
+
+# Compares the cost of 256 `Option_unwrap` call sites with and without `OPTION_CALL_SITES`:
+# - the code size of the hot path, which competes for the instruction cache, and of the cold path moved out of line;
+# - the total section sizes and the dynamic relocations, which descriptors holding pointers would add in PIE builds.
+# Usage: call-sites-report.sh <build-directory>
+
+set -e
+
+BUILD_DIRECTORY="${1:-.}"
+
+# prints the size of symbol ${2} in executable ${1}, 0 if missing
+symbolSize() {
+    local HEX
+    HEX="$(nm --print-size --defined-only "${1}" | awk -v symbol="${2}" '$4 == symbol { print $2 }')"
+    echo $((16#${HEX:-0}))
+}
+
+# prints the size of section ${2} in executable ${1}, 0 if missing
+sectionSize() {
+    local HEX
+    HEX="$(readelf --wide --section-headers "${1}" | sed 's/^ *\[ *[0-9]*\]//' |
+        awk -v section="${2}" '$1 == section { print $5 }')"
+    echo $((16#${HEX:-0}))
+}
+
+for EXECUTABLE in benchmark-call-sites benchmark-call-sites-table; do
+    PATHNAME="${BUILD_DIRECTORY}/${EXECUTABLE}"
+    HOT="$(symbolSize "${PATHNAME}" unwrapAll)"
+    COLD="$(symbolSize "${PATHNAME}" unwrapAll.cold)"
+    RELOCATIONS="$(readelf --wide --relocs "${PATHNAME}" | grep -c '^[0-9a-f]\{8,\} ' || true)"
+    RELATIVE="$(readelf --wide --relocs "${PATHNAME}" | grep -c '_RELATIVE' || true)"
+    printf "%s\n  hot path: %6d bytes (%d bytes/site), cold path: %6d bytes\n" \
+        "${EXECUTABLE}" "${HOT}" $((HOT / 256)) "${COLD}"
+    printf "  .text: %d bytes, .rodata: %d bytes, .data.rel.ro: %d bytes, option_call_sites: %d bytes\n" \
+        "$(sectionSize "${PATHNAME}" .text)" "$(sectionSize "${PATHNAME}" .rodata)" \
+        "$(sectionSize "${PATHNAME}" .data.rel.ro)" "$(sectionSize "${PATHNAME}" option_call_sites)"
+    printf "  .rela.dyn: %d bytes, dynamic relocations: %d (%d relative)\n" \
+        "$(sectionSize "${PATHNAME}" .rela.dyn)" "${RELOCATIONS}" "${RELATIVE}"
+    size "${PATHNAME}" | tail -n 1
+    "${PATHNAME}"
+done
@@ -0,0 +1,67 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <option.h>
+#include "benchmark.h"
+
+/*
+ * A function with 256 `Option_unwrap` call sites, built both with and without `OPTION_CALL_SITES`:
+ * `call-sites-report.sh` compares the size of `unwrapAll` in the two executables, running them compares the speed.
+ */
+
+#define ITERATIONS  1000000
+
+#define SITE        result = Option_unwrap(items[i++ % 8]); Benchmark_keep(result);
+#define SITES_4     SITE SITE SITE SITE
+#define SITES_16    SITES_4 SITES_4 SITES_4 SITES_4
+#define SITES_64    SITES_16 SITES_16 SITES_16 SITES_16
+#define SITES_256   SITES_64 SITES_64 SITES_64 SITES_64
+
+const void *unwrapAll(const Option *items)
+__attribute__((__noinline__));
+
+int main() {
+    static const char value[] = "A";
+    const Option items[8] = {
+            Option_some(value), Option_some(value), Option_some(value), Option_some(value),
+            Option_some(value), Option_some(value), Option_some(value), Option_some(value),
+    };
+
+#if defined(OPTION_CALL_SITES)
+    Benchmark_run("256 x Option_unwrap (call site tables)", ITERATIONS, Benchmark_keep(unwrapAll(items)));
+#else
+    Benchmark_run("256 x Option_unwrap (file and line)", ITERATIONS, Benchmark_keep(unwrapAll(items)));
+#endif
+    return 0;
+}
+
+const void *unwrapAll(const Option *const items) {
+    const void *result = NULL;
+    size_t i = 0;
+    SITES_256
+    return result;
+}
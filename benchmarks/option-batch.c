@@ -0,0 +1,121 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <option-batch.h>
+#include "benchmark.h"
+
+/*
+ * Compares the batch kernels against a scalar loop calling `Option_isSome`.
+ */
+
+#define LENGTH      (1u << 20u)
+#define ROUNDS      100
+
+int main() {
+    static const char value[] = "A";
+    Option *items = malloc(LENGTH * sizeof(items[0]));
+    uint64_t *mask = malloc((LENGTH + 63) / 64 * sizeof(mask[0]));
+    const void **values = malloc(LENGTH * sizeof(values[0]));
+    if (NULL == items || NULL == mask || NULL == values) {
+        return 1;
+    }
+
+    srand(42);
+    for (size_t i = 0; i < LENGTH; i++) {
+        items[i] = rand() % 2 ? Option_some(value) : None;
+    }
+
+    printf("kernels: %s, items: %u\n", Option_batchKernels(), LENGTH);
+
+    Benchmark_run("count (Option_isSome loop)", ROUNDS, {
+        size_t count = 0;
+        for (size_t i = 0; i < LENGTH; i++) {
+            count += Option_isSome(items[i]);
+        }
+        Benchmark_keep(count);
+    });
+
+    Benchmark_run("count (Option_countSome)", ROUNDS, {
+        const size_t count = Option_countSome(items, LENGTH);
+        Benchmark_keep(count);
+    });
+
+    Benchmark_run("mask (Option_isSome loop)", ROUNDS, {
+        for (size_t i = 0; i < LENGTH; i += 64) {
+            uint64_t word = 0;
+            for (size_t j = 0; j < 64; j++) {
+                word |= (uint64_t) Option_isSome(items[i + j]) << j;
+            }
+            mask[i / 64] = word;
+        }
+        Benchmark_keep(mask);
+    });
+
+    Benchmark_run("mask (Option_maskSome)", ROUNDS, {
+        Option_maskSome(items, LENGTH, mask);
+        Benchmark_keep(mask);
+    });
+
+    Benchmark_run("compact (Option_isSome loop)", ROUNDS, {
+        size_t count = 0;
+        for (size_t i = 0; i < LENGTH; i++) {
+            if (Option_isSome(items[i])) {
+                values[count++] = Option_unwrap(items[i]);
+            }
+        }
+        Benchmark_keep(count);
+    });
+
+    Benchmark_run("compact (Option_compactSome)", ROUNDS, {
+        const size_t count = Option_compactSome(items, LENGTH, values);
+        Benchmark_keep(count);
+    });
+
+    items[LENGTH - 1] = None;
+    for (size_t i = 0; i < LENGTH - 1; i++) {
+        items[i] = Option_some(value);
+    }
+
+    Benchmark_run("find (Option_isSome loop)", ROUNDS, {
+        size_t i = 0;
+        while (i < LENGTH && Option_isSome(items[i])) {
+            i++;
+        }
+        Benchmark_keep(i);
+    });
+
+    Benchmark_run("find (Option_findNone)", ROUNDS, {
+        const size_t index = Option_findNone(items, LENGTH);
+        Benchmark_keep(index);
+    });
+
+    free(values);
+    free(mask);
+    free(items);
+    return 0;
+}
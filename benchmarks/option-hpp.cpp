@@ -0,0 +1,99 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <optional>
+#include <option.hpp>
+#include "benchmark.h"
+
+/*
+ * Compares a map/chain/alt chain over option::Option with the same chain written over std::optional
+ * and with hand-written checks, for an inline payload and for a pointer payload (niche vs tagged).
+ */
+
+#define ITERATIONS  100000000
+
+static int half(const int value) {
+    return value / 2;
+}
+
+static option::Option<int> odd(const int value) {
+    return value % 2 ? option::some(value) : option::Option<int>();
+}
+
+static std::optional<int> stdOdd(const int value) {
+    return value % 2 ? std::optional<int>(value) : std::nullopt;
+}
+
+int main() {
+    static const int values[4] = {1, 2, 3, 4};
+    volatile size_t source = 0;
+
+    Benchmark_run("int: hand-written checks", ITERATIONS, {
+        const int value = (int) (source + __i);
+        int result = -1;
+        if (value >= 0) {
+            const int mapped = half(value);
+            if (mapped % 2) {
+                result = mapped;
+            }
+        }
+        Benchmark_keep(result);
+    });
+
+    Benchmark_run("int: option::Option", ITERATIONS, {
+        const int value = (int) (source + __i);
+        const int result = (value >= 0 ? option::some(value) : option::none)
+                .map(half).chain(odd).unwrapOr(-1);
+        Benchmark_keep(result);
+    });
+
+    Benchmark_run("int: std::optional", ITERATIONS, {
+        const int value = (int) (source + __i);
+        std::optional<int> option = value >= 0 ? std::optional<int>(value) : std::nullopt;
+        option = option.has_value() ? std::optional<int>(half(*option)) : std::nullopt;
+        option = option.has_value() ? stdOdd(*option) : std::nullopt;
+        const int result = option.value_or(-1);
+        Benchmark_keep(result);
+    });
+
+    Benchmark_run("pointer: option::Option (niche)", ITERATIONS, {
+        const int *const value = values + ((source + __i) & 3);
+        const option::Option<const int *> result = option::fromNullable(value)
+                .map([](const int *v) { return *v % 2 ? v : nullptr; });
+        Benchmark_keep(result.isSome());
+    });
+
+    Benchmark_run("pointer: std::optional", ITERATIONS, {
+        const int *const value = values + ((source + __i) & 3);
+        std::optional<const int *> result = nullptr != value ? std::optional<const int *>(value) : std::nullopt;
+        result = result.has_value() && **result % 2 ? result : std::nullopt;
+        Benchmark_keep(result.has_value());
+    });
+
+    static_assert(sizeof(option::Option<const int *>) < sizeof(std::optional<const int *>));
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdlib.h>
+#include <option-iterator.h>
+#include "benchmark.h"
+
+/*
+ * Compares a filter + map + sum pipeline written by hand, with the fused statement macros and with a runtime chain.
+ */
+
+#define LENGTH      (1u << 20u)
+#define ROUNDS      100
+
+static bool isEven(const void *value) {
+    return 0 == *(const int *) value % 2;
+}
+
+static const void *twice(const void *value) {
+    static int result;
+    result = *(const int *) value * 2;
+    return &result;
+}
+
+static const void *sum(const void *accumulator, const void *value) {
+    return (const void *) ((uintptr_t) accumulator + (uintptr_t) *(const int *) value);
+}
+
+int main() {
+    int *items = malloc(LENGTH * sizeof(items[0]));
+    if (NULL == items) {
+        return 1;
+    }
+
+    srand(42);
+    for (size_t i = 0; i < LENGTH; i++) {
+        items[i] = rand() % 1000;
+    }
+
+    printf("items: %u\n", LENGTH);
+
+    Benchmark_run("filter+map+sum (hand-written loop)", ROUNDS, {
+        uintptr_t total = 0;
+        for (size_t i = 0; i < LENGTH; i++) {
+            if (isEven(items + i)) {
+                total += (uintptr_t) *(const int *) twice(items + i);
+            }
+        }
+        Benchmark_keep(total);
+    });
+
+    Benchmark_run("filter+map+sum (OptionIterator_for*)", ROUNDS, {
+        uintptr_t total = 0;
+        OptionIterator_forArray(value, items, LENGTH, sizeof(items[0]))
+            OptionIterator_forFilter(value, isEven)
+                OptionIterator_forMap(value, twice) {
+                    total += (uintptr_t) *(const int *) value;
+                }
+        Benchmark_keep(total);
+    });
+
+    Benchmark_run("filter+map+sum (runtime chain)", ROUNDS, {
+        OptionIterator source, evens, doubled;
+        OptionIterator_fromArray(&source, items, LENGTH, sizeof(items[0]));
+        OptionIterator_filter(&evens, &source, isEven);
+        OptionIterator_map(&doubled, &evens, twice);
+        const void *total = OptionIterator_fold(&doubled, NULL, sum);
+        Benchmark_keep(total);
+    });
+
+    free(items);
+    return 0;
+}
@@ -0,0 +1,88 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <option-parallel.h>
+#include "benchmark.h"
+
+/*
+ * Measures the scaling of `Option_parallelChain` with the number of workers against a serial `Option_chain` loop.
+ */
+
+#define LENGTH      10000000u
+#define ROUNDS      10
+
+static const int digits[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+static Option rotate(const void *value) {
+    const int *digit = value;
+    // a little work per item, so that memory bandwidth is not the only bottleneck
+    unsigned hash = (unsigned) *digit;
+    for (unsigned i = 0; i < 16; i++) {
+        hash = hash * 2654435761u + i;
+    }
+    return 0 == hash % 97 ? None : Option_some(digits + (*digit + 1) % 10);
+}
+
+static void fill(Option *const items) {
+    for (size_t i = 0; i < LENGTH; i++) {
+        items[i] = Option_some(digits + i % 10);
+    }
+}
+
+int main() {
+    Option *items = malloc(LENGTH * sizeof(items[0]));
+    if (NULL == items) {
+        return 1;
+    }
+    const long online = sysconf(_SC_NPROCESSORS_ONLN);
+    printf("processors: %ld, items: %u\n", online, LENGTH);
+
+    fill(items);
+    Benchmark_run("Option_chain loop", ROUNDS, {
+        for (size_t i = 0; i < LENGTH; i++) {
+            items[i] = Option_chain(items[i], rotate);
+        }
+        Benchmark_keep(items);
+    });
+
+    for (size_t workers = 1; workers <= (size_t) (online > 0 ? online : 1); workers *= 2) {
+        char name[64];
+        snprintf(name, sizeof(name), "Option_parallelChain (%zu workers)", workers);
+        OptionPool *pool = OptionPool_new(workers);
+        fill(items);
+        Benchmark_run(name, ROUNDS, {
+            Option_parallelChain(pool, items, LENGTH, rotate);
+            Benchmark_keep(items);
+        });
+        OptionPool_delete(pool);
+    }
+
+    free(items);
+    return 0;
+}
@@ -0,0 +1,176 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <option-promise.h>
+#include "benchmark.h"
+
+/*
+ * Compares `OptionPromise` with a mutex/condition variable cell for cross-thread handoff:
+ * - handoff: a producer fulfils a sequence of cells that a consumer waits on in order (throughput);
+ * - ping-pong: two threads fulfil each other's cells in turn (round-trip latency).
+ */
+
+#define ROUNDS      100000u
+
+typedef struct Cell {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    const void *value;
+} Cell;
+
+static const int token = 42;
+
+static void Cell_fulfill(Cell *const self, const void *const value) {
+    pthread_mutex_lock(&self->mutex);
+    self->value = value;
+    pthread_cond_broadcast(&self->cond);
+    pthread_mutex_unlock(&self->mutex);
+}
+
+static const void *Cell_wait(Cell *const self) {
+    pthread_mutex_lock(&self->mutex);
+    while (NULL == self->value) {
+        pthread_cond_wait(&self->cond, &self->mutex);
+    }
+    const void *const value = self->value;
+    pthread_mutex_unlock(&self->mutex);
+    return value;
+}
+
+static OptionPromise *newPromises(void) {
+    OptionPromise *promises = malloc(ROUNDS * sizeof(promises[0]));
+    for (size_t i = 0; NULL != promises && i < ROUNDS; i++) {
+        OptionPromise_init(&promises[i]);
+    }
+    return promises;
+}
+
+static Cell *newCells(void) {
+    Cell *cells = malloc(ROUNDS * sizeof(cells[0]));
+    for (size_t i = 0; NULL != cells && i < ROUNDS; i++) {
+        pthread_mutex_init(&cells[i].mutex, NULL);
+        pthread_cond_init(&cells[i].cond, NULL);
+        cells[i].value = NULL;
+    }
+    return cells;
+}
+
+static void deleteCells(Cell *const cells) {
+    for (size_t i = 0; i < ROUNDS; i++) {
+        pthread_cond_destroy(&cells[i].cond);
+        pthread_mutex_destroy(&cells[i].mutex);
+    }
+    free(cells);
+}
+
+static void *producePromises(void *promises) {
+    for (size_t i = 0; i < ROUNDS; i++) {
+        OptionPromise_fulfill((OptionPromise *) promises + i, &token);
+    }
+    return NULL;
+}
+
+static void *produceCells(void *cells) {
+    for (size_t i = 0; i < ROUNDS; i++) {
+        Cell_fulfill((Cell *) cells + i, &token);
+    }
+    return NULL;
+}
+
+static void *pongPromises(void *promises) {
+    OptionPromise *const ping = promises, *const pong = ping + ROUNDS / 2;
+    for (size_t i = 0; i < ROUNDS / 2; i++) {
+        OptionPromise_fulfill(&pong[i], Option_unwrap(OptionPromise_wait(&ping[i])));
+    }
+    return NULL;
+}
+
+static void *pongCells(void *cells) {
+    Cell *const ping = cells, *const pong = ping + ROUNDS / 2;
+    for (size_t i = 0; i < ROUNDS / 2; i++) {
+        Cell_fulfill(&pong[i], Cell_wait(&ping[i]));
+    }
+    return NULL;
+}
+
+int main() {
+    OptionPromise *promises = newPromises();
+    Cell *cells = newCells();
+    if (NULL == promises || NULL == cells) {
+        return 1;
+    }
+    pthread_t thread;
+    uint64_t start;
+
+    start = Benchmark_now();
+    pthread_create(&thread, NULL, producePromises, promises);
+    for (size_t i = 0; i < ROUNDS; i++) {
+        Benchmark_keep(Option_unwrap(OptionPromise_wait(&promises[i])));
+    }
+    pthread_join(thread, NULL);
+    Benchmark_report("OptionPromise handoff", ROUNDS, Benchmark_now() - start);
+
+    start = Benchmark_now();
+    pthread_create(&thread, NULL, produceCells, cells);
+    for (size_t i = 0; i < ROUNDS; i++) {
+        Benchmark_keep(Cell_wait(&cells[i]));
+    }
+    pthread_join(thread, NULL);
+    Benchmark_report("mutex/cond handoff", ROUNDS, Benchmark_now() - start);
+
+    free(promises);
+    deleteCells(cells);
+    promises = newPromises();
+    cells = newCells();
+    if (NULL == promises || NULL == cells) {
+        return 1;
+    }
+
+    start = Benchmark_now();
+    pthread_create(&thread, NULL, pongPromises, promises);
+    for (size_t i = 0; i < ROUNDS / 2; i++) {
+        OptionPromise_fulfill(&promises[i], &token);
+        Benchmark_keep(Option_unwrap(OptionPromise_wait(&promises[ROUNDS / 2 + i])));
+    }
+    pthread_join(thread, NULL);
+    Benchmark_report("OptionPromise ping-pong round-trip", ROUNDS / 2, Benchmark_now() - start);
+
+    start = Benchmark_now();
+    pthread_create(&thread, NULL, pongCells, cells);
+    for (size_t i = 0; i < ROUNDS / 2; i++) {
+        Cell_fulfill(&cells[i], &token);
+        Benchmark_keep(Cell_wait(&cells[ROUNDS / 2 + i]));
+    }
+    pthread_join(thread, NULL);
+    Benchmark_report("mutex/cond ping-pong round-trip", ROUNDS / 2, Benchmark_now() - start);
+
+    free(promises);
+    deleteCells(cells);
+    return 0;
+}
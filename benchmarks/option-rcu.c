@@ -0,0 +1,140 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <option-rcu.h>
+#include "benchmark.h"
+
+/*
+ * Measures the read throughput of a published configuration with 1 to 64 reader threads, while a writer replaces
+ * it every millisecond, using `OptionRcu` and a `pthread_rwlock_t` baseline.
+ */
+
+#define READS       200000u
+#define MAX_READERS 64u
+
+typedef struct Config {
+    int timeout;
+    int retries;
+} Config;
+
+static OptionRcu rcuConfig = OPTION_RCU_INIT;
+static pthread_rwlock_t lockedRwlock = PTHREAD_RWLOCK_INITIALIZER;
+static Config *lockedConfig = NULL;
+static int stop = 0;
+
+static Config *newConfig(const int version) {
+    Config *config = malloc(sizeof(*config));
+    if (NULL == config) {
+        abort();
+    }
+    *config = (Config) {.timeout=version, .retries=3};
+    return config;
+}
+
+static void *readRcu(void *_) {
+    (void) _;
+    long sum = 0;
+    for (size_t i = 0; i < READS; i++) {
+        OptionRcu_readLock();
+        const Config *config = OptionRcu_read(&rcuConfig).__value;
+        sum += config->timeout + config->retries;
+        OptionRcu_readUnlock();
+    }
+    Benchmark_keep(sum);
+    return NULL;
+}
+
+static void *readLocked(void *_) {
+    (void) _;
+    long sum = 0;
+    for (size_t i = 0; i < READS; i++) {
+        pthread_rwlock_rdlock(&lockedRwlock);
+        sum += lockedConfig->timeout + lockedConfig->retries;
+        pthread_rwlock_unlock(&lockedRwlock);
+    }
+    Benchmark_keep(sum);
+    return NULL;
+}
+
+static void *writeRcu(void *_) {
+    (void) _;
+    for (int version = 1; !__atomic_load_n(&stop, __ATOMIC_ACQUIRE); version++) {
+        OptionRcu_publish(&rcuConfig, Option_some(newConfig(version)), free);
+        usleep(1000);
+    }
+    return NULL;
+}
+
+static void *writeLocked(void *_) {
+    (void) _;
+    for (int version = 1; !__atomic_load_n(&stop, __ATOMIC_ACQUIRE); version++) {
+        Config *config = newConfig(version);
+        pthread_rwlock_wrlock(&lockedRwlock);
+        Config *old = lockedConfig;
+        lockedConfig = config;
+        pthread_rwlock_unlock(&lockedRwlock);
+        free(old);
+        usleep(1000);
+    }
+    return NULL;
+}
+
+static void run(const char *const kind, const size_t readers, void *read(void *), void *write(void *)) {
+    pthread_t threads[MAX_READERS], writer;
+    char name[64];
+    snprintf(name, sizeof(name), "%s (%zu readers)", kind, readers);
+    __atomic_store_n(&stop, 0, __ATOMIC_RELEASE);
+    pthread_create(&writer, NULL, write, NULL);
+    const uint64_t start = Benchmark_now();
+    for (size_t i = 0; i < readers; i++) {
+        pthread_create(&threads[i], NULL, read, NULL);
+    }
+    for (size_t i = 0; i < readers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    Benchmark_report(name, readers * READS, Benchmark_now() - start);
+    __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+    pthread_join(writer, NULL);
+}
+
+int main() {
+    printf("processors: %ld, reads per reader: %u\n", sysconf(_SC_NPROCESSORS_ONLN), READS);
+    OptionRcu_publish(&rcuConfig, Option_some(newConfig(0)), free);
+    lockedConfig = newConfig(0);
+
+    for (size_t readers = 1; readers <= MAX_READERS; readers *= 2) {
+        run("OptionRcu", readers, readRcu, writeRcu);
+        run("pthread_rwlock", readers, readLocked, writeLocked);
+    }
+
+    OptionRcu_publish(&rcuConfig, None, free);
+    free(lockedConfig);
+    return 0;
+}
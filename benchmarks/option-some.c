@@ -0,0 +1,74 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <option.h>
+#include <panic/panic.h>
+#include "benchmark.h"
+
+/*
+ * Compares the cost of the contract check in `Option_some`:
+ * the legacy path always calls the out-of-line `__Panic_when`, the current one tests the condition inline.
+ */
+
+#define ITERATIONS  100000000
+
+static Option legacySome(const void *value)
+__attribute__((__noinline__));
+
+static Option inlineSome(const void *value)
+__attribute__((__noinline__));
+
+int main() {
+    static const char value[] = "A";
+
+    Benchmark_run("Option_some (legacy __Panic_when)", ITERATIONS, {
+        const Option option = legacySome(value);
+        Benchmark_keep(option.__value);
+    });
+
+    Benchmark_run("Option_some (inline Panic_when)", ITERATIONS, {
+        const Option option = inlineSome(value);
+        Benchmark_keep(option.__value);
+    });
+
+    Benchmark_run("Option_some (library)", ITERATIONS, {
+        const Option option = Option_some(value);
+        Benchmark_keep(option.__value);
+    });
+
+    return 0;
+}
+
+Option legacySome(const void *const value) {
+    __Panic_when((__FILE__), (__LINE__), ("NULL == value"), (NULL == value));
+    return (Option) {.__value=value};
+}
+
+Option inlineSome(const void *const value) {
+    Panic_when(NULL == value);
+    return (Option) {.__value=value};
+}
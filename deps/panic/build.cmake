@@ -7,9 +7,11 @@ message("${ARCHIVE_NAME}@${CMAKE_CURRENT_LIST_DIR} using: ${CMAKE_CURRENT_LIST_F
 file(GLOB ARCHIVE_HEADERS ${CMAKE_CURRENT_LIST_DIR}/*.h)
 file(GLOB ARCHIVE_SOURCES ${CMAKE_CURRENT_LIST_DIR}/*.c)
 add_library(${ARCHIVE_NAME} ${ARCHIVE_HEADERS} ${ARCHIVE_SOURCES})
+target_link_libraries(${ARCHIVE_NAME} PRIVATE ${CMAKE_DL_LIBS})
 
 # Optional features
 option(PANIC_UNWIND_SUPPORT "Stack unwinding support" OFF)
+option(PANIC_FRAME_POINTER_SUPPORT "Stack walking support through frame pointers" OFF)
 
 ###################
 # Private section
@@ -77,7 +79,18 @@ if (PANIC_UNWIND_SUPPORT)
     if (LIBUNWIND_FOUND)
         target_link_libraries(${ARCHIVE_NAME} PRIVATE unwind)
         add_definitions(-DPANIC_UNWIND_SUPPORT=1)
+        # export the functions of executables so that the traceback can name them
+        set(CMAKE_ENABLE_EXPORTS ON)
     else ()
         message(FATAL_ERROR "libunwind required for PANIC_UNWIND_SUPPORT feature but not found")
     endif ()
 endif (PANIC_UNWIND_SUPPORT)
+
+if (PANIC_FRAME_POINTER_SUPPORT)
+    # the walk stops at the first function built without frame pointers
+    add_compile_options(-fno-omit-frame-pointer)
+    target_compile_options(${ARCHIVE_NAME} PRIVATE -fno-omit-frame-pointer)
+    add_definitions(-DPANIC_FRAME_POINTER_SUPPORT=1)
+    # export the functions of executables so that the traceback can name them
+    set(CMAKE_ENABLE_EXPORTS ON)
+endif (PANIC_FRAME_POINTER_SUPPORT)
@@ -0,0 +1,61 @@
+#!/usr/bin/env bash
+
+# Symbolizes the raw traceback of a panic report using the load map that follows it.
+# Frames are resolved with addr2line against the module containing them, after removing the load bias.
+# Usage: panic-symbolize.sh [report-file]    (reads stdin if no file is given)
+
+set -euo pipefail
+
+command -v addr2line > /dev/null || { echo "addr2line not found" >&2; exit 1; }
+
+frames=()
+indices=()
+starts=()
+ends=()
+biases=()
+paths=()
+section=""
+
+while IFS= read -r line; do
+    line="${line%$'\r'}"
+    case "${line}" in
+        "Traceback (most recent call last):")
+            section="frames"; frames=(); indices=(); starts=(); ends=(); biases=(); paths=() ;;
+        "  [ ]: (...)")
+            ;;
+        "Modules:")
+            section="modules" ;;
+        "  ["*"]: 0x"*)
+            if [[ "${section}" == "frames" ]]; then
+                index="${line#  [}"
+                rest="${line#*]: 0x}"
+                indices+=("${index%%]*}")
+                frames+=("${rest%% *}")
+            fi ;;
+        "  0x"*)
+            if [[ "${section}" == "modules" ]]; then
+                read -r range bias path <<< "${line}"
+                start="${range%%-*}"
+                starts+=("$((16#${start#0x}))")
+                ends+=("$((16#${range##*-0x}))")
+                biases+=("$((16#${bias#0x}))")
+                paths+=("${path}")
+            fi ;;
+        *)
+            section="" ;;
+    esac
+done < "${1:-/dev/stdin}"
+
+for i in "${!frames[@]}"; do
+    # return addresses point after the call instruction
+    address=$((16#${frames[${i}]} - (indices[i] > 0 ? 1 : 0)))
+    symbol="??"
+    for m in "${!paths[@]}"; do
+        if (( starts[m] <= address && address < ends[m] )); then
+            offset=$(printf '0x%x' $((address - biases[m])))
+            symbol="$(addr2line -f -C -i -p -e "${paths[${m}]}" "${offset}") (${paths[${m}]}+${offset})"
+            break
+        fi
+    done
+    printf '  [%s]: 0x%s %s\n' "${indices[${i}]}" "${frames[${i}]}" "${symbol}"
+done
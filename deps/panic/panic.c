@@ -25,25 +25,107 @@ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
 OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <time.h>
 #include <errno.h>
-#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <link.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/syscall.h>
 #include "panic.h"
 
+/*
+ * Hooks form a singly linked list sorted by decreasing priority, nodes are inserted with a CAS and never unlinked:
+ * unregistering only disables the node, so a panicking thread can always walk the list without locks.
+ */
+typedef struct HookNode {
+    Panic_Hook hook;
+    void *context;
+    int priority;
+    bool enabled;
+    struct HookNode *next;
+} HookNode;
+
 static Panic_Callback globalCallback = NULL;
+static HookNode *globalHooks = NULL;
+static int globalReportSink = -1;
+static int globalOpenedReportSink = -1;     // the sink opened by Panic_openReportSink, if still owned by the library
 
 static void terminate(const char *file, int line, const char *format, ...)
-__attribute__((__noinline__, __noreturn__, __nonnull__(1, 3), __format__(__printf__, 3, 4)));
+__attribute__((__cold__, __noinline__, __noreturn__, __nonnull__(1, 3), __format__(__printf__, 3, 4)));
 
 static void vterminate(const char *file, int line, const char *format, va_list args)
-__attribute__((__noinline__, __noreturn__, __nonnull__(1, 3), __format__(__printf__, 3, 0)));
+__attribute__((__cold__, __noinline__, __noreturn__, __nonnull__(1, 3), __format__(__printf__, 3, 0)));
 
 Panic_Callback Panic_registerCallback(const Panic_Callback callback) {
-    const Panic_Callback backup = callback;
-    globalCallback = callback;
-    return backup;
+    return __atomic_exchange_n(&globalCallback, callback, __ATOMIC_ACQ_REL);
+}
+
+bool Panic_registerHook(const Panic_Hook hook, void *const context, const int priority) {
+    assert(NULL != hook);
+    HookNode *const node = malloc(sizeof(*node));
+    if (NULL == node) {
+        return false;
+    }
+    *node = (HookNode) {.hook=hook, .context=context, .priority=priority, .enabled=true, .next=NULL};
+
+    HookNode **link = &globalHooks;
+    HookNode *next = __atomic_load_n(link, __ATOMIC_ACQUIRE);
+    for (;;) {
+        // skip the nodes that run before this one
+        while (NULL != next && next->priority >= priority) {
+            link = &next->next;
+            next = __atomic_load_n(link, __ATOMIC_ACQUIRE);
+        }
+        node->next = next;
+        // on failure next is reloaded and the walk resumes from link, which is still a valid predecessor
+        if (__atomic_compare_exchange_n(link, &next, node, false, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE)) {
+            return true;
+        }
+    }
+}
+
+bool Panic_unregisterHook(const Panic_Hook hook, void *const context) {
+    assert(NULL != hook);
+    bool found = false;
+    for (HookNode *node = __atomic_load_n(&globalHooks, __ATOMIC_ACQUIRE);
+         NULL != node; node = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE)) {
+        if (hook == node->hook && context == node->context &&
+            __atomic_exchange_n(&node->enabled, false, __ATOMIC_ACQ_REL)) {
+            found = true;
+        }
+    }
+    return found;
+}
+
+int Panic_setReportSink(const int fd) {
+    const int previous = __atomic_exchange_n(&globalReportSink, fd < 0 ? -1 : fd, __ATOMIC_ACQ_REL);
+    // a sink opened by the library and returned here now belongs to the caller
+    int opened = previous;
+    __atomic_compare_exchange_n(&globalOpenedReportSink, &opened, -1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    return previous;
+}
+
+int Panic_openReportSink(const char *const path) {
+    assert(NULL != path);
+    const int fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (0 <= fd) {
+        const int previous = __atomic_exchange_n(&globalReportSink, fd, __ATOMIC_ACQ_REL);
+        const int opened = __atomic_exchange_n(&globalOpenedReportSink, fd, __ATOMIC_ACQ_REL);
+        if (0 <= opened && opened == previous) {
+            close(previous);
+        }
+    }
+    return fd;
 }
 
 void __Panic_terminate(const char *const file, const int line, const char *const format, ...) {
@@ -77,16 +159,112 @@ void __Panic_unless(const char *const file, const int line, const char *const me
 }
 
 /*
- *
+ * Reports are formatted into preallocated per-thread buffers by a minimal async-signal-safe formatter,
+ * then emitted with a single write(2): no stdio lock is taken and no memory is allocated, so a panic can be
+ * reported from a signal handler and the reports of concurrent panics never interleave.
  */
-#define NEWLINE "\r\n"
+#define NEWLINE         "\r\n"
+#define TRUNCATED       "..." NEWLINE
+#define CAUSE_SIZE      1024
+#define REPORT_SIZE     16384
+#define FRAMES_SIZE     128
+#define FRAMES_SKIP     3       // doTerminate, (v)terminate and __Panic_(v)terminate
+#define FRAMES_MAX_DISTANCE (1u << 20)
+#define SITES_SIZE      256     // power of 2
+
+typedef struct {
+    char *start;
+    char *cursor;
+    char *end;
+} Writer;
+
+typedef struct {
+    Writer *writer;
+    bool json;
+    size_t count;
+} ModuleWriter;
+
+typedef struct {
+    const char *file;
+    int line;
+    uint64_t count;
+} Site;
+
+static __thread char threadCause[CAUSE_SIZE];
+static __thread char threadReport[REPORT_SIZE];
+static __thread void *threadFrames[FRAMES_SIZE];
+static __thread bool threadPanicking = false;
+static bool globalPanicking = false;
+static Site globalSites[SITES_SIZE];
 
 static void doTerminate(const char *file, int line, const char *format, va_list args)
-__attribute__((__noreturn__, __nonnull__(1, 3), __format__(__printf__, 3, 0)));
+__attribute__((__noinline__, __noreturn__, __nonnull__(1, 3), __format__(__printf__, 3, 0)));
+
+static size_t captureFrames(void **frames, size_t capacity)
+__attribute__((__noinline__, __nonnull__));
 
-static void backtrace(FILE *stream)
+static void backtrace(Writer *writer, void *const *frames, size_t size)
 __attribute__((__nonnull__));
 
+static void putSymbol(Writer *writer, const void *address)
+__attribute__((__nonnull__));
+
+static int putModule(struct dl_phdr_info *info, size_t size, void *data)
+__attribute__((__nonnull__));
+
+static uint64_t countSite(const char *file, int line)
+__attribute__((__nonnull__));
+
+static void reportJson(int fd, const Panic_Report *report, void *const *frames, size_t framesSize)
+__attribute__((__nonnull__));
+
+static void runHooks(const Panic_Report *report)
+__attribute__((__nonnull__));
+
+static long threadId(void);
+
+static void lockPanic(void);
+
+static void unlockPanic(void);
+
+static void writeAll(int fd, const char *data, size_t size)
+__attribute__((__nonnull__));
+
+static Writer Writer_new(char *buffer, size_t size)
+__attribute__((__nonnull__));
+
+static size_t Writer_finish(Writer *self)
+__attribute__((__nonnull__));
+
+static void Writer_putChar(Writer *self, char c)
+__attribute__((__nonnull__));
+
+static void Writer_putString(Writer *self, const char *string)
+__attribute__((__nonnull__));
+
+static void Writer_putSigned(Writer *self, intmax_t value)
+__attribute__((__nonnull__));
+
+static void Writer_putUnsigned(Writer *self, uintmax_t value, unsigned base)
+__attribute__((__nonnull__));
+
+static void Writer_putJsonString(Writer *self, const char *string)
+__attribute__((__nonnull__));
+
+static void Writer_vformat(Writer *self, const char *format, va_list args)
+__attribute__((__nonnull__(1, 2), __format__(__printf__, 2, 0)));
+
+size_t __Panic_format(char *const buffer, const size_t size, const char *const format, ...) {
+    assert(NULL != buffer);
+    assert(NULL != format);
+    va_list args;
+    va_start(args, format);
+    Writer writer = Writer_new(buffer, size);
+    Writer_vformat(&writer, format, args);
+    va_end(args);
+    return Writer_finish(&writer);
+}
+
 void terminate(const char *file, int line, const char *format, ...) {
     assert(NULL != file);
     assert(NULL != format);
@@ -104,87 +282,798 @@ void vterminate(const char *file, int line, const char *format, va_list args) {
 void doTerminate(const char *file, int line, const char *format, va_list args) {
     assert(NULL != file);
     assert(NULL != format);
-    fputs(NEWLINE, stderr);
-    backtrace(stderr);
-    fprintf(stderr, "   At: %s:%d" NEWLINE, file, line);
-    if (0 != errno) {
-        fprintf(stderr, "Error: (%d) %s" NEWLINE, errno, strerror(errno));
-    }
-    fputs("Cause: ", stderr);
-    vfprintf(stderr, format, args);
-    fputs(NEWLINE, stderr);
+    const int error = errno;
+    const bool nested = threadPanicking;    // panicking again while running the callback
+
+    if (!nested) {
+        lockPanic();
+    }
+    const size_t framesSize = captureFrames(threadFrames, FRAMES_SIZE);
+
+    Writer cause = Writer_new(threadCause, sizeof(threadCause));
+    Writer_vformat(&cause, format, args);
+    Writer_finish(&cause);
     va_end(args);
-    if (NULL != globalCallback) {
-        globalCallback();
+
+    Writer report = Writer_new(threadReport, sizeof(threadReport));
+    Writer_putString(&report, NEWLINE);
+    backtrace(&report, threadFrames, framesSize);
+    Writer_putString(&report, "   At: ");
+    Writer_putString(&report, file);
+    Writer_putChar(&report, ':');
+    Writer_putSigned(&report, line);
+    Writer_putString(&report, NEWLINE);
+    if (0 != error) {
+        Writer_putString(&report, "Error: (");
+        Writer_putSigned(&report, error);
+        Writer_putChar(&report, ')');
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 32))
+        // unlike strerror, strerrordesc_np neither allocates nor depends on the locale
+        const char *const description = strerrordesc_np(error);
+        if (NULL != description) {
+            Writer_putChar(&report, ' ');
+            Writer_putString(&report, description);
+        }
+#endif
+        Writer_putString(&report, NEWLINE);
+    }
+    Writer_putString(&report, "Cause: ");
+    Writer_putString(&report, threadCause);
+    Writer_putString(&report, NEWLINE);
+    writeAll(STDERR_FILENO, threadReport, Writer_finish(&report));
+
+    const Panic_Report panicReport = {
+            .file=file, .line=line, .cause=threadCause, .threadId=threadId(), .error=error
+    };
+    const int sink = __atomic_load_n(&globalReportSink, __ATOMIC_ACQUIRE);
+    if (0 <= sink) {
+        reportJson(sink, &panicReport, threadFrames, framesSize);
+    }
+
+    if (!nested) {
+        runHooks(&panicReport);
+        const Panic_Callback callback = __atomic_load_n(&globalCallback, __ATOMIC_ACQUIRE);
+        if (NULL != callback) {
+            callback();
+        }
+        unlockPanic();
     }
     abort();
 }
 
-#if !defined(PANIC_UNWIND_SUPPORT) && PANIC_UNWIND_SUPPORT == 0
-
-void backtrace(FILE *const stream) {
-    assert(NULL != stream);
-    (void) stream;
+void runHooks(const Panic_Report *const report) {
+    assert(NULL != report);
+    for (HookNode *node = __atomic_load_n(&globalHooks, __ATOMIC_ACQUIRE);
+         NULL != node; node = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE)) {
+        if (__atomic_load_n(&node->enabled, __ATOMIC_ACQUIRE)) {
+            node->hook(report, node->context);
+        }
+    }
 }
 
+long threadId(void) {
+#if defined(SYS_gettid)
+    return syscall(SYS_gettid);
 #else
+    return (long) getpid();
+#endif
+}
 
-#define UNW_LOCAL_ONLY
+/*
+ * Counts the panics raised at file:line in a fixed-size open addressing table, sites are identified by the
+ * address of their file name. Returns 0 if the table is full.
+ */
+uint64_t countSite(const char *const file, const int line) {
+    assert(NULL != file);
+    const uintptr_t hash = ((uintptr_t) file >> 3) * 31 + (uintptr_t) line;
+    for (size_t i = 0; i < SITES_SIZE; i++) {
+        Site *const site = globalSites + ((hash + i) & (SITES_SIZE - 1));
+        const char *expected = NULL;
+        if (!__atomic_compare_exchange_n(&site->file, &expected, file, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) &&
+            expected != file) {
+            continue;
+        }
+        // the slot is claimed by file, now claim its line: 0 is the value of a fresh slot
+        int expectedLine = 0;
+        if (__atomic_compare_exchange_n(&site->line, &expectedLine, line, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) ||
+            expectedLine == line) {
+            return __atomic_add_fetch(&site->count, 1, __ATOMIC_RELAXED);
+        }
+    }
+    return 0;
+}
 
-#include <libunwind.h>
+/*
+ * Writes the report as a single JSON line, in the per-thread report buffer.
+ * Modules are dropped if the report does not fit.
+ */
+void reportJson(const int fd, const Panic_Report *const report, void *const *const frames, const size_t framesSize) {
+    assert(NULL != report);
+    assert(NULL != frames);
+    struct timespec now = {0};
+    clock_gettime(CLOCK_REALTIME, &now);
+    const uint64_t siteCount = countSite(report->file, report->line);
 
-void backtrace(FILE *const stream) {
-    assert(NULL != stream);
-    const int previousError = errno;
-    size_t size = 0;
-    const size_t N_SIZE = 8, M_SIZE = 32;
+    for (int withModules = 1; withModules >= 0; withModules--) {
+        Writer writer = Writer_new(threadReport, sizeof(threadReport));
+        Writer_putString(&writer, "{\"timestamp\":");
+        Writer_putUnsigned(&writer, (uintmax_t) now.tv_sec * 1000000000u + (uintmax_t) now.tv_nsec, 10);
+        Writer_putString(&writer, ",\"pid\":");
+        Writer_putSigned(&writer, getpid());
+        Writer_putString(&writer, ",\"tid\":");
+        Writer_putSigned(&writer, report->threadId);
+        Writer_putString(&writer, ",\"file\":");
+        Writer_putJsonString(&writer, report->file);
+        Writer_putString(&writer, ",\"line\":");
+        Writer_putSigned(&writer, report->line);
+        Writer_putString(&writer, ",\"siteCount\":");
+        Writer_putUnsigned(&writer, siteCount, 10);
+        Writer_putString(&writer, ",\"errno\":");
+        Writer_putSigned(&writer, report->error);
+        Writer_putString(&writer, ",\"cause\":");
+        Writer_putJsonString(&writer, report->cause);
+        Writer_putString(&writer, ",\"frames\":[");
+        for (size_t i = 0; i < framesSize; i++) {
+            Writer_putString(&writer, 0 == i ? "\"0x" : ",\"0x");
+            Writer_putUnsigned(&writer, (uintptr_t) frames[i], 16);
+            Writer_putChar(&writer, '"');
+        }
+        Writer_putString(&writer, "]");
+        if (withModules && 0 < framesSize) {
+            Writer_putString(&writer, ",\"modules\":[");
+            dl_iterate_phdr(putModule, &(ModuleWriter) {.writer=&writer, .json=true, .count=0});
+            Writer_putString(&writer, "]");
+        }
+        Writer_putString(&writer, "}\n");
+        if (writer.cursor <= writer.end) {
+            writeAll(fd, threadReport, Writer_finish(&writer));
+            return;
+        }
+    }
+}
+
+/*
+ * The first panicking thread takes the process-wide lock, the others wait for it to report and run the callback.
+ * The lock is released right before abort(), so that a thread recovering from a panic (e.g. by jumping out of a
+ * SIGABRT handler) does not keep holding it.
+ */
+void lockPanic(void) {
+    const struct timespec pause = {.tv_sec=0, .tv_nsec=1000000};
+    while (__atomic_test_and_set(&globalPanicking, __ATOMIC_ACQUIRE)) {
+        nanosleep(&pause, NULL);
+    }
+    threadPanicking = true;
+}
+
+void unlockPanic(void) {
+    threadPanicking = false;
+    __atomic_clear(&globalPanicking, __ATOMIC_RELEASE);
+}
+
+void writeAll(const int fd, const char *data, size_t size) {
+    assert(NULL != data);
+    while (0 < size) {
+        const ssize_t written = write(fd, data, size);
+        if (written < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return;
+        }
+        data += written;
+        size -= (size_t) written;
+    }
+}
+
+/*
+ * Writer: formats into a fixed-size buffer, output exceeding the buffer is dropped and marked as truncated.
+ */
+Writer Writer_new(char *const buffer, const size_t size) {
+    assert(NULL != buffer);
+    assert(sizeof(TRUNCATED) < size);
+    // keep room for the truncation marker and the terminator
+    return (Writer) {.start=buffer, .cursor=buffer, .end=buffer + size - sizeof(TRUNCATED)};
+}
+
+size_t Writer_finish(Writer *const self) {
+    assert(NULL != self);
+    if (self->cursor > self->end) {
+        self->cursor = self->end;
+        memcpy(self->cursor, TRUNCATED, sizeof(TRUNCATED) - 1);
+        self->cursor += sizeof(TRUNCATED) - 1;
+    }
+    *self->cursor = '\0';
+    return (size_t) (self->cursor - self->start);
+}
 
-    char buffer[N_SIZE][M_SIZE + 1];
-    unw_cursor_t cursor;
-    unw_context_t context;
+void Writer_putChar(Writer *const self, const char c) {
+    assert(NULL != self);
+    if (self->cursor < self->end) {
+        *self->cursor = c;
+    }
+    // past the end the cursor keeps moving, without writing, to record the truncation
+    if (self->cursor <= self->end) {
+        self->cursor++;
+    }
+}
+
+void Writer_putString(Writer *const self, const char *string) {
+    assert(NULL != self);
+    assert(NULL != string);
+    while ('\0' != *string) {
+        Writer_putChar(self, *string++);
+    }
+}
+
+void Writer_putJsonString(Writer *const self, const char *string) {
+    assert(NULL != self);
+    assert(NULL != string);
+    Writer_putChar(self, '"');
+    for (; '\0' != *string; string++) {
+        const unsigned char c = (unsigned char) *string;
+        if ('"' == c || '\\' == c) {
+            Writer_putChar(self, '\\');
+            Writer_putChar(self, (char) c);
+        } else if ('\n' == c) {
+            Writer_putString(self, "\\n");
+        } else if ('\r' == c) {
+            Writer_putString(self, "\\r");
+        } else if ('\t' == c) {
+            Writer_putString(self, "\\t");
+        } else if (c < 0x20) {
+            Writer_putString(self, "\\u00");
+            Writer_putChar(self, "0123456789abcdef"[c >> 4]);
+            Writer_putChar(self, "0123456789abcdef"[c & 0xf]);
+        } else {
+            Writer_putChar(self, (char) c);
+        }
+    }
+    Writer_putChar(self, '"');
+}
+
+/*
+ * Formats value into the end of buffer, returns the first digit.
+ */
+static char *formatUnsigned(char *end, uintmax_t value, const unsigned base, const bool upper) {
+    const char *const digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    do {
+        *--end = digits[value % base];
+        value /= base;
+    } while (0 != value);
+    return end;
+}
 
-    memset(&context, 0, sizeof(context));
-    memset(&cursor, 0, sizeof(cursor));
-    memset(buffer, 0, N_SIZE * M_SIZE);
+void Writer_putSigned(Writer *const self, const intmax_t value) {
+    assert(NULL != self);
+    if (value < 0) {
+        Writer_putChar(self, '-');
+        Writer_putUnsigned(self, -(uintmax_t) value, 10);
+    } else {
+        Writer_putUnsigned(self, (uintmax_t) value, 10);
+    }
+}
 
-    unw_getcontext(&context);
-    unw_init_local(&cursor, &context);
+void Writer_putUnsigned(Writer *const self, const uintmax_t value, const unsigned base) {
+    assert(NULL != self);
+    char buffer[sizeof(uintmax_t) * 8 + 1];
+    buffer[sizeof(buffer) - 1] = '\0';
+    Writer_putString(self, formatUnsigned(buffer + sizeof(buffer) - 1, value, base, false));
+}
 
-    // skip: (v)terminate and __Panic_(v)terminate function calls
-    for (size_t i = 0; i < 3; i++) {
-        if (unw_step(&cursor) <= 0) {
-            errno = previousError;  // restore errno
-            return;                 // something wrong, exit
+/*
+ * Writes text padded to width, zeros go after the sign and the `0x` prefix.
+ */
+static void putPadded(Writer *const self, const char *text, size_t length,
+                      const int width, const bool left, const char pad) {
+    size_t padding = 0 < width && (size_t) width > length ? (size_t) width - length : 0;
+    if (!left && '0' == pad) {
+        size_t prefix = 0 < length && ('-' == text[0] || '+' == text[0] || ' ' == text[0]) ? 1 : 0;
+        if (prefix + 1 < length && '0' == text[prefix] && ('x' == text[prefix + 1] || 'X' == text[prefix + 1])) {
+            prefix += 2;
+        }
+        for (; 0 < prefix; prefix--, length--) {
+            Writer_putChar(self, *text++);
+        }
+    }
+    if (!left) {
+        for (; 0 < padding; padding--) {
+            Writer_putChar(self, pad);
         }
     }
+    for (size_t i = 0; i < length; i++) {
+        Writer_putChar(self, text[i]);
+    }
+    for (; 0 < padding; padding--) {
+        Writer_putChar(self, ' ');
+    }
+}
+
+/*
+ * Splits value into the integral and fractional digits of its rounded representation, with precision fractional
+ * digits, normalizing it to a single integral digit if scientific; returns the decimal exponent.
+ * Ties are rounded to even, as printf does.
+ */
+static int splitDouble(long double value, const int precision, const bool scientific,
+                       uintmax_t *const integral, uintmax_t *const fractional) {
+    int exponent = 0;
+    if (scientific && 0 != value) {
+        // scale by 1e16 first: fewer steps, fewer rounding errors
+        for (; value >= 1e16L; value /= 1e16L, exponent += 16);
+        for (; value >= 10; value /= 10, exponent++);
+        for (; value < 1e-16L; value *= 1e16L, exponent -= 16);
+        for (; value < 1; value *= 10, exponent--);
+    }
 
-    for (size_t i = 0; i < N_SIZE && unw_step(&cursor) > 0; i++) {
-        if (unw_get_proc_name(&cursor, buffer[i], M_SIZE, NULL) == 0) {
-            size += 1;
-            if (strcmp("main", buffer[i]) == 0) {
+    long double scale = 1;
+    for (int i = 0; i < precision; i++) {
+        scale *= 10;
+    }
+    *integral = (uintmax_t) value;
+    const long double scaled = (value - (long double) *integral) * scale;
+    *fractional = (uintmax_t) scaled;
+    const long double remainder = scaled - (long double) *fractional;
+    if (remainder > 0.5L || (0.5L == remainder && 0 != ((0 < precision ? *fractional : *integral) & 1))) {
+        *fractional += 1;
+    }
+    if ((long double) *fractional >= scale) {
+        *integral += 1;
+        *fractional = 0;
+    }
+    if (scientific && *integral >= 10) {
+        *integral = 1;
+        exponent++;
+    }
+    return exponent;
+}
+
+/*
+ * Formats a floating point number as printf does, except that fixed notation switches to scientific notation
+ * from 1e18 and that precision is capped at 18 digits.
+ */
+static size_t formatDouble(char *const buffer, long double value, int precision, const char conversion,
+                           const bool alternate, const char sign) {
+    const bool upper = 'F' == conversion || 'E' == conversion || 'G' == conversion;
+    char *cursor = buffer;
+    if (__builtin_signbit(value)) {
+        *cursor++ = '-';
+        value = -value;
+    } else if ('\0' != sign) {
+        *cursor++ = sign;
+    }
+    if (value != value || value - value != 0) {
+        memcpy(cursor, value != value ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf"), 3);
+        return (size_t) (cursor - buffer) + 3;
+    }
+
+    precision = precision < 0 ? 6 : precision > 18 ? 18 : precision;
+    bool scientific = 'e' == conversion || 'E' == conversion || value >= 1e18L;
+    bool strip = false;
+    uintmax_t integral, fractional;
+    int exponent;
+    if ('g' == conversion || 'G' == conversion) {
+        // the exponent of the value rounded to precision significant digits selects the notation
+        const int significant = 0 == precision ? 1 : precision;
+        exponent = splitDouble(value, significant - 1, true, &integral, &fractional);
+        scientific = value >= 1e18L || exponent < -4 || exponent >= significant;
+        precision = scientific ? significant - 1 : significant - 1 - exponent;
+        strip = !alternate;
+    }
+    exponent = splitDouble(value, precision, scientific, &integral, &fractional);
+
+    char digits[sizeof(uintmax_t) * 8 + 1];
+    const char *text = formatUnsigned(digits + sizeof(digits), integral, 10, false);
+    memcpy(cursor, text, (size_t) (digits + sizeof(digits) - text));
+    cursor += digits + sizeof(digits) - text;
+    if (0 < precision || alternate) {
+        *cursor++ = '.';
+    }
+    if (0 < precision) {
+        text = formatUnsigned(digits + sizeof(digits), fractional, 10, false);
+        for (size_t i = (size_t) (digits + sizeof(digits) - text); i < (size_t) precision; i++) {
+            *cursor++ = '0';
+        }
+        memcpy(cursor, text, (size_t) (digits + sizeof(digits) - text));
+        cursor += digits + sizeof(digits) - text;
+    }
+    if (strip && (0 < precision || alternate)) {
+        for (; '0' == cursor[-1]; cursor--);
+        cursor -= '.' == cursor[-1] ? 1 : 0;
+    }
+    if (scientific) {
+        *cursor++ = upper ? 'E' : 'e';
+        *cursor++ = exponent < 0 ? '-' : '+';
+        text = formatUnsigned(digits + sizeof(digits), (uintmax_t) (exponent < 0 ? -exponent : exponent), 10, false);
+        if (digits + sizeof(digits) - text < 2) {
+            *cursor++ = '0';
+        }
+        memcpy(cursor, text, (size_t) (digits + sizeof(digits) - text));
+        cursor += digits + sizeof(digits) - text;
+    }
+    return (size_t) (cursor - buffer);
+}
+
+/*
+ * Supports the flags `-0+ #`, width, precision, the length modifiers `hh h l ll j z t L` and
+ * the conversions `d i u o x X c s p f F e E g G %`, matching glibc except for the limits of formatDouble;
+ * other conversions, such as `a` and `n`, are copied verbatim.
+ */
+void Writer_vformat(Writer *const self, const char *format, va_list args) {
+    assert(NULL != self);
+    assert(NULL != format);
+    for (; '\0' != *format; format++) {
+        if ('%' != *format) {
+            Writer_putChar(self, *format);
+            continue;
+        }
+
+        const char *const specification = format++;
+        bool left = false, plus = false, space = false, alternate = false;
+        char pad = ' ';
+        for (;; format++) {
+            if ('-' == *format) {
+                left = true;
+            } else if ('0' == *format) {
+                pad = '0';
+            } else if ('+' == *format) {
+                plus = true;
+            } else if (' ' == *format) {
+                space = true;
+            } else if ('#' == *format) {
+                alternate = true;
+            } else {
                 break;
             }
+        }
+
+        int width = 0, precision = -1;
+        if ('*' == *format) {
+            width = va_arg(args, int);
+            if (width < 0) {
+                left = true;
+                width = -width;
+            }
+            format++;
         } else {
-            break; // something wrong, stop unwinding
+            for (; '0' <= *format && *format <= '9'; format++) {
+                width = width * 10 + (*format - '0');
+            }
+        }
+        if ('.' == *format) {
+            format++;
+            precision = 0;
+            if ('*' == *format) {
+                precision = va_arg(args, int);
+                format++;
+            } else {
+                for (; '0' <= *format && *format <= '9'; format++) {
+                    precision = precision * 10 + (*format - '0');
+                }
+            }
         }
-    }
 
-    if (0 == size) {
-        errno = previousError;  // restore errno
-        return;                 // something wrong, exit
+        enum {
+            LENGTH_INT, LENGTH_CHAR, LENGTH_SHORT, LENGTH_LONG, LENGTH_LONG_LONG,
+            LENGTH_INTMAX, LENGTH_SIZE, LENGTH_PTRDIFF, LENGTH_LONG_DOUBLE
+        } length = LENGTH_INT;
+        if ('h' == format[0] && 'h' == format[1]) {
+            length = LENGTH_CHAR, format += 2;
+        } else if ('l' == format[0] && 'l' == format[1]) {
+            length = LENGTH_LONG_LONG, format += 2;
+        } else if ('h' == *format) {
+            length = LENGTH_SHORT, format++;
+        } else if ('l' == *format) {
+            length = LENGTH_LONG, format++;
+        } else if ('j' == *format) {
+            length = LENGTH_INTMAX, format++;
+        } else if ('z' == *format) {
+            length = LENGTH_SIZE, format++;
+        } else if ('t' == *format) {
+            length = LENGTH_PTRDIFF, format++;
+        } else if ('L' == *format) {
+            length = LENGTH_LONG_DOUBLE, format++;
+        }
+
+        char buffer[sizeof(uintmax_t) * 8 + 64];
+        char *const end = buffer + sizeof(buffer);
+        switch (*format) {
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+            case 'p': {
+                bool negative = false;
+                uintmax_t value;
+                if ('p' == *format) {
+                    value = (uintptr_t) va_arg(args, void *);
+                    if (0 == value) {
+                        putPadded(self, "(nil)", 5, width, left, ' ');
+                        break;
+                    }
+                    alternate = true;
+                } else if ('d' == *format || 'i' == *format) {
+                    intmax_t signedValue;
+                    switch (length) {
+                        case LENGTH_CHAR:
+                            signedValue = (signed char) va_arg(args, int);
+                            break;
+                        case LENGTH_SHORT:
+                            signedValue = (short) va_arg(args, int);
+                            break;
+                        case LENGTH_LONG:
+                            signedValue = va_arg(args, long);
+                            break;
+                        case LENGTH_LONG_LONG:
+                            signedValue = va_arg(args, long long);
+                            break;
+                        case LENGTH_INTMAX:
+                            signedValue = va_arg(args, intmax_t);
+                            break;
+                        case LENGTH_SIZE:
+                        case LENGTH_PTRDIFF:
+                            signedValue = va_arg(args, ptrdiff_t);
+                            break;
+                        default:
+                            signedValue = va_arg(args, int);
+                            break;
+                    }
+                    negative = signedValue < 0;
+                    value = negative ? -(uintmax_t) signedValue : (uintmax_t) signedValue;
+                } else {
+                    switch (length) {
+                        case LENGTH_CHAR:
+                            value = (unsigned char) va_arg(args, unsigned);
+                            break;
+                        case LENGTH_SHORT:
+                            value = (unsigned short) va_arg(args, unsigned);
+                            break;
+                        case LENGTH_LONG:
+                            value = va_arg(args, unsigned long);
+                            break;
+                        case LENGTH_LONG_LONG:
+                            value = va_arg(args, unsigned long long);
+                            break;
+                        case LENGTH_INTMAX:
+                            value = va_arg(args, uintmax_t);
+                            break;
+                        case LENGTH_SIZE:
+                        case LENGTH_PTRDIFF:
+                            value = va_arg(args, size_t);
+                            break;
+                        default:
+                            value = va_arg(args, unsigned);
+                            break;
+                    }
+                }
+
+                const unsigned base = 'o' == *format ? 8 : ('x' == *format || 'X' == *format || 'p' == *format) ? 16 : 10;
+                char *text = (0 == precision && 0 == value) ? end : formatUnsigned(end, value, base, 'X' == *format);
+                for (int digits = (int) (end - text); digits < precision; digits++) {
+                    *--text = '0';
+                }
+                if (alternate && 16 == base && 0 != value) {
+                    *--text = 'X' == *format ? 'X' : 'x';
+                    *--text = '0';
+                } else if (alternate && 8 == base && (end == text || '0' != *text)) {
+                    *--text = '0';
+                }
+                if (negative) {
+                    *--text = '-';
+                } else if (plus && 10 == base && 'u' != *format) {
+                    *--text = '+';
+                } else if (space && 10 == base && 'u' != *format) {
+                    *--text = ' ';
+                }
+                putPadded(self, text, (size_t) (end - text), width, left, 0 <= precision || left ? ' ' : pad);
+                break;
+            }
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G': {
+                const long double value = LENGTH_LONG_DOUBLE == length ? va_arg(args, long double) : va_arg(args, double);
+                const char sign = plus ? '+' : space ? ' ' : '\0';
+                const size_t size = formatDouble(buffer, value, precision, *format, alternate, sign);
+                // infinities and NaNs are never zero padded
+                putPadded(self, buffer, size, width, left, left || value - value != 0 ? ' ' : pad);
+                break;
+            }
+            case 'c':
+                buffer[0] = (char) va_arg(args, int);
+                putPadded(self, buffer, 1, width, left, ' ');
+                break;
+            case 's': {
+                const char *string = va_arg(args, const char *);
+                string = NULL == string ? "(null)" : string;
+                size_t size = 0;
+                while ((precision < 0 || size < (size_t) precision) && '\0' != string[size]) {
+                    size++;
+                }
+                putPadded(self, string, size, width, left, ' ');
+                break;
+            }
+            case '%':
+                Writer_putChar(self, '%');
+                break;
+            default:
+                // unsupported conversion: copy it verbatim, its argument (if any) cannot be consumed safely
+                for (const char *c = specification; c <= format && '\0' != *c; c++) {
+                    Writer_putChar(self, *c);
+                }
+                if ('\0' == *format) {
+                    return;
+                }
+                break;
+        }
     }
+}
+
+/*
+ * Frames are captured as raw return addresses, the report names them with dladdr and carries the load map
+ * of the process so that they can also be symbolized offline (see panic-symbolize.sh).
+ */
+#if defined(PANIC_UNWIND_SUPPORT) && PANIC_UNWIND_SUPPORT
 
-    fputs("Traceback (most recent call last):" NEWLINE, stream);
-    if (strcmp("main", buffer[size - 1]) != 0) {
-        fputs("  [ ]: (...)" NEWLINE, stream);
+#define UNW_LOCAL_ONLY
+
+#include <libunwind.h>
+
+size_t captureFrames(void **const frames, const size_t capacity) {
+    assert(NULL != frames);
+    // the first frame is captureFrames itself
+    void *buffer[1 + FRAMES_SKIP + FRAMES_SIZE];
+    const size_t skip = 1 + FRAMES_SKIP;
+    const size_t limit = capacity < FRAMES_SIZE ? capacity : FRAMES_SIZE;
+    const int size = unw_backtrace(buffer, (int) (skip + limit));
+    if (size <= (int) skip) {
+        return 0;
     }
-    for (size_t i = 1; i < size; i++) {
-        fprintf(stream, "  [%zu]: (%s)" NEWLINE, i - 1, buffer[size - i]);
+    memcpy(frames, buffer + skip, ((size_t) size - skip) * sizeof(frames[0]));
+    return (size_t) size - skip;
+}
+
+#elif defined(PANIC_FRAME_POINTER_SUPPORT) && PANIC_FRAME_POINTER_SUPPORT
+
+size_t captureFrames(void **const frames, const size_t capacity) {
+    assert(NULL != frames);
+    // every frame starts with the saved frame pointer of the caller followed by the return address
+    void *const *frame = __builtin_frame_address(0);
+    size_t size = 0;
+    for (size_t i = 0; NULL != frame && size < capacity; i++) {
+        void *const *const next = frame[0];
+        void *const address = frame[1];
+        if (NULL == address) {
+            break;
+        }
+        if (i >= FRAMES_SKIP) {
+            frames[size++] = address;
+        }
+        // the stack grows downwards: a caller frame below, misaligned or too far from this one means a broken chain
+        if (next <= frame || (uintptr_t) next % sizeof(void *) || (uintptr_t) next - (uintptr_t) frame > FRAMES_MAX_DISTANCE) {
+            break;
+        }
+        frame = next;
     }
-    fprintf(stream, "  ->-: (%s) current function" NEWLINE, buffer[0]);
-    fputs(NEWLINE, stream);
+    return size;
+}
+
+#else
 
-    errno = previousError;  // restore errno
+size_t captureFrames(void **const frames, const size_t capacity) {
+    assert(NULL != frames);
+    (void) frames;
+    (void) capacity;
+    return 0;
 }
 
 #endif
+
+void backtrace(Writer *const writer, void *const *const frames, const size_t size) {
+    assert(NULL != writer);
+    assert(NULL != frames);
+    if (0 == size) {
+        return;
+    }
+    Writer_putString(writer, "Traceback (most recent call last):" NEWLINE);
+    if (FRAMES_SIZE == size) {
+        Writer_putString(writer, "  [ ]: (...)" NEWLINE);
+    }
+    for (size_t i = size; i-- > 0;) {
+        Writer_putString(writer, "  [");
+        Writer_putUnsigned(writer, i, 10);
+        Writer_putString(writer, "]: 0x");
+        Writer_putUnsigned(writer, (uintptr_t) frames[i], 16);
+        Writer_putString(writer, " (");
+        putSymbol(writer, frames[i]);
+        Writer_putString(writer, 0 == i ? ") current function" NEWLINE : ")" NEWLINE);
+    }
+    Writer_putString(writer, "Modules:" NEWLINE);
+    dl_iterate_phdr(putModule, &(ModuleWriter) {.writer=writer, .json=false, .count=0});
+    Writer_putString(writer, NEWLINE);
+}
+
+/*
+ * Writes `function+0x<offset>` for the return address, or `module+0x<offset>` if the function is unknown.
+ * dladdr only sees dynamic symbols: executables must export theirs (-rdynamic) to have their functions named,
+ * panic-symbolize.sh resolves every frame from the debug info instead.
+ * Like dl_iterate_phdr, dladdr is not async-signal-safe on paper, but it neither allocates nor uses stdio.
+ */
+void putSymbol(Writer *const writer, const void *const address) {
+    assert(NULL != writer);
+    assert(NULL != address);
+    Dl_info info;
+    // return addresses point after the call instruction, possibly past the end of the calling function
+    if (0 == dladdr((const char *) address - 1, &info)) {
+        Writer_putString(writer, "??");
+    } else if (NULL != info.dli_sname && NULL != info.dli_saddr) {
+        Writer_putString(writer, info.dli_sname);
+        Writer_putString(writer, "+0x");
+        Writer_putUnsigned(writer, (uintptr_t) address - (uintptr_t) info.dli_saddr, 16);
+    } else {
+        const char *const slash = NULL == info.dli_fname ? NULL : strrchr(info.dli_fname, '/');
+        Writer_putString(writer, NULL == slash ? (NULL == info.dli_fname ? "??" : info.dli_fname) : slash + 1);
+        Writer_putString(writer, "+0x");
+        Writer_putUnsigned(writer, (uintptr_t) address - (uintptr_t) info.dli_fbase, 16);
+    }
+}
+
+/*
+ * Writes every loaded object having executable segments, as a line `  0x<start>-0x<end> 0x<bias> <path>`
+ * or as a JSON object. dl_iterate_phdr is not async-signal-safe on paper, but it neither allocates nor uses stdio.
+ */
+int putModule(struct dl_phdr_info *const info, const size_t size, void *const data) {
+    assert(NULL != info);
+    assert(NULL != data);
+    (void) size;
+    ModuleWriter *const self = data;
+    Writer *const writer = self->writer;
+    uintptr_t start = UINTPTR_MAX, end = 0;
+    for (size_t i = 0; i < info->dlpi_phnum; i++) {
+        const ElfW(Phdr) *const header = info->dlpi_phdr + i;
+        if (PT_LOAD == header->p_type && (header->p_flags & PF_X)) {
+            const uintptr_t segmentStart = info->dlpi_addr + header->p_vaddr;
+            const uintptr_t segmentEnd = segmentStart + header->p_memsz;
+            start = segmentStart < start ? segmentStart : start;
+            end = segmentEnd > end ? segmentEnd : end;
+        }
+    }
+    if (start >= end) {
+        return 0;
+    }
+
+    char buffer[1024];
+    const char *path = info->dlpi_name;
+    if (NULL == path || '\0' == path[0]) {
+        // the main executable has an empty name
+        const ssize_t length = readlink("/proc/self/exe", buffer, sizeof(buffer) - 1);
+        buffer[0 < length ? length : 0] = '\0';
+        path = 0 < length ? buffer : "?";
+    }
+
+    if (self->json) {
+        Writer_putString(writer, 0 == self->count ? "{\"start\":\"0x" : ",{\"start\":\"0x");
+        Writer_putUnsigned(writer, start, 16);
+        Writer_putString(writer, "\",\"end\":\"0x");
+        Writer_putUnsigned(writer, end, 16);
+        Writer_putString(writer, "\",\"bias\":\"0x");
+        Writer_putUnsigned(writer, info->dlpi_addr, 16);
+        Writer_putString(writer, "\",\"path\":");
+        Writer_putJsonString(writer, path);
+        Writer_putChar(writer, '}');
+    } else {
+        Writer_putString(writer, "  0x");
+        Writer_putUnsigned(writer, start, 16);
+        Writer_putString(writer, "-0x");
+        Writer_putUnsigned(writer, end, 16);
+        Writer_putString(writer, " 0x");
+        Writer_putUnsigned(writer, info->dlpi_addr, 16);
+        Writer_putChar(writer, ' ');
+        Writer_putString(writer, path);
+        Writer_putString(writer, NEWLINE);
+    }
+    self->count++;
+    return 0;
+}
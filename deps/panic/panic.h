@@ -28,6 +28,7 @@ OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 #include <stdarg.h>
+#include <stddef.h>
 #include <stdbool.h>
 
 #if !(defined(__GNUC__) || defined(__clang__))
@@ -51,13 +52,84 @@ extern "C" {
 typedef void (*Panic_Callback)(void);
 
 /**
- * Registers a callback to execute before terminating.
+ * Registers a callback to execute before terminating, after every hook.
+ * Registration is atomic and may race with other registrations and with panics.
  *
  * @param callback The callback to be executed, if NULL nothing will be executed.
  * @return The previous registered callback if any else NULL.
  */
 extern Panic_Callback Panic_registerCallback(Panic_Callback callback);
 
+/**
+ * Context of a panic, handed to hooks.
+ * The strings are only valid for the duration of the hook call.
+ */
+typedef struct Panic_Report {
+    const char *file;
+    int line;
+    const char *cause;
+    long threadId;
+    int error;      // the value of errno when the panic was raised
+} Panic_Report;
+
+/**
+ * Type signature of the hooks to be executed before terminating.
+ * A hook must not return control to the panicking code by other means than returning,
+ * a panic raised by a hook is reported but no other hook will run.
+ */
+typedef void (*Panic_Hook)(const Panic_Report *report, void *context);
+
+/**
+ * Registers a hook to execute before terminating, hooks run in decreasing priority order,
+ * hooks having the same priority run in registration order.
+ * Registration is lock-free and may race with other registrations and with panics.
+ *
+ * @param hook The hook to be executed.
+ * @param context The context forwarded to the hook.
+ * @param priority The priority of the hook.
+ * @return `true` if the hook was registered, `false` if memory could not be allocated.
+ *
+ * @attention hook must not be `NULL`.
+ */
+extern bool Panic_registerHook(Panic_Hook hook, void *context, int priority)
+__attribute__((__nonnull__(1)));
+
+/**
+ * Disables every registration of hook with context.
+ *
+ * @return `true` if at least one registration was disabled else `false`.
+ *
+ * @attention hook must not be `NULL`.
+ */
+extern bool Panic_unregisterHook(Panic_Hook hook, void *context)
+__attribute__((__nonnull__(1)));
+
+/**
+ * Sets the file descriptor receiving a machine-readable copy of every panic report, -1 disables it.
+ * Each report is a single JSON line written with one write(2), holding the fields:
+ * `timestamp` (nanoseconds since the epoch), `pid`, `tid`, `file`, `line`, `siteCount` (panics raised so far
+ * at file:line, 0 if unknown), `errno`, `cause`, `frames` (raw return addresses, most recent first) and,
+ * if frames were captured, `modules` (the load map needed to symbolize frames offline).
+ * The human-readable report is still written to stderr.
+ *
+ * @param fd The file descriptor of the sink, it is not closed by the library.
+ * @return The previous file descriptor, -1 if none; the caller is responsible for closing it.
+ */
+extern int Panic_setReportSink(int fd);
+
+/**
+ * Opens path for appending, creating it if needed, and sets it as report sink.
+ * The sink previously opened by this function is closed, unless it was replaced or returned by
+ * `Panic_setReportSink(...)` in the meantime, in which case it belongs to the caller.
+ *
+ * @param path The path of the sink.
+ * @return The file descriptor of the sink, -1 on failure (errno is set).
+ *
+ * @attention path must not be `NULL`.
+ */
+extern int Panic_openReportSink(const char *path)
+__attribute__((__nonnull__));
+
 /**
  * Reports the error and terminates execution.
  * Takes printf-like arguments.
@@ -67,36 +139,53 @@ extern Panic_Callback Panic_registerCallback(Panic_Callback callback);
 
 /**
  * Terminates execution if condition is `true`.
+ * The condition is tested inline, only the failing branch jumps to the out-of-line reporter.
  */
 #define Panic_when(condition) \
-    __Panic_when((__FILE__), (__LINE__), (#condition), (condition))
+    (__builtin_expect(!!(condition), 0) \
+        ? __Panic_terminate((__FILE__), (__LINE__), "(%s) evaluates to `true`", (#condition)) \
+        : (void) 0)
 
 /**
  * Terminates execution if condition is `false`.
+ * The condition is tested inline, only the failing branch jumps to the out-of-line reporter.
  */
 #define Panic_unless(condition) \
-    __Panic_unless((__FILE__), (__LINE__), (#condition), (condition))
+    (__builtin_expect(!!(condition), 1) \
+        ? (void) 0 \
+        : __Panic_terminate((__FILE__), (__LINE__), "(%s) evaluates to `false`", (#condition)))
 
 /**
  * @attention this function must be treated as opaque therefore should not be called directly.
  */
 extern void __Panic_terminate(const char *file, int line, const char *format, ...)
-__attribute__((__noinline__, __noreturn__, __nonnull__(1, 3), __format__(__printf__, 3, 4)));
+__attribute__((__cold__, __noinline__, __noreturn__, __nonnull__(1, 3), __format__(__printf__, 3, 4)));
 
 /**
  * @attention this function must be treated as opaque therefore should not be called directly.
  */
 extern void __Panic_vterminate(const char *file, int line, const char *format, va_list args)
-__attribute__((__noinline__, __noreturn__, __nonnull__(1, 3), __format__(__printf__, 3, 0)));
+__attribute__((__cold__, __noinline__, __noreturn__, __nonnull__(1, 3), __format__(__printf__, 3, 0)));
+
+/**
+ * Formats into buffer with the async-signal-safe formatter of the reports, exposed for testing.
+ * Output exceeding size is dropped and marked with a trailing "...\r\n".
+ *
+ * @attention this function must be treated as opaque therefore should not be called directly.
+ */
+extern size_t __Panic_format(char *buffer, size_t size, const char *format, ...)
+__attribute__((__nonnull__(1, 3), __format__(__printf__, 3, 4)));
 
 /**
  * @attention this function must be treated as opaque therefore should not be called directly.
+ * @deprecated kept for ABI compatibility only, `Panic_when` no longer calls it.
  */
 extern void __Panic_when(const char *file, int line, const char *message, bool condition)
 __attribute__((__noinline__, __nonnull__(1, 3)));
 
 /**
  * @attention this function must be treated as opaque therefore should not be called directly.
+ * @deprecated kept for ABI compatibility only, `Panic_unless` no longer calls it.
  */
 extern void __Panic_unless(const char *file, int line, const char *message, bool condition)
 __attribute__((__noinline__, __nonnull__(1, 3)));
@@ -1,3 +1,6 @@
 add_executable(main ${CMAKE_CURRENT_LIST_DIR}/main.c)
 target_link_libraries(main PRIVATE m option)
-target_compile_options(main PRIVATE -Wno-incompatible-pointer-types)
+set_target_properties(main PROPERTIES C_STANDARD 11)
+
+add_executable(typed-option ${CMAKE_CURRENT_LIST_DIR}/typed-option.c)
+target_link_libraries(typed-option PRIVATE m panic)
@@ -27,8 +27,8 @@ OTHER DEALINGS IN THE SOFTWARE.
 
 #include <math.h>
 #include <stdio.h>
-#include <option.h>
-#include <assert.h>
+#include <option-generic.h>
+#include <option-arena.h>
 
 typedef const double *Number;
 
@@ -47,19 +47,20 @@ int main() {
             )
     );
     printf("Number is: %f\n", *number);
+    OptionArena_reset(OptionArena_thread());
     return 0;
 }
 
 /*
  *
  */
-static double numbers[4] = {};
-static double *numbersCursor = numbers;
-static const double *numbersEnd = numbers + sizeof(numbers) / sizeof(numbers[0]);
-
 Number Number_new(const double number) {
-    assert(numbersCursor <= numbersEnd);
-    return (*zero() == number) ? zero() : (*numbersCursor = number, numbersCursor++);
+    if (*zero() == number) {
+        return zero();
+    }
+    double *instance = OptionArena_alloc(OptionArena_thread(), sizeof(*instance), _Alignof(double));
+    *instance = number;
+    return instance;
 }
 
 Number zero(void) {
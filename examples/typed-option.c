@@ -0,0 +1,63 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <typed-option.h>
+
+OPTION_DEFINE(double, OptionDouble)
+
+static double cube(double number);
+static OptionDouble division(double dividend, double divisor);
+static OptionDouble squareRoot(double number);
+
+int main() {
+    const double number = OPTION_UNWRAP(
+            OptionDouble,
+            OptionDouble_alt(
+                    OptionDouble_map(OptionDouble_chain(division(36, 4), squareRoot), cube),
+                    OptionDouble_some(0)
+            )
+    );
+    printf("Number is: %f\n", number);
+    return 0;
+}
+
+/*
+ *
+ */
+double cube(const double number) {
+    return pow(number, 3);
+}
+
+OptionDouble division(const double dividend, const double divisor) {
+    return divisor == 0.0 ? OptionDouble_none() : OptionDouble_some(dividend / divisor);
+}
+
+OptionDouble squareRoot(const double number) {
+    return number < 0.0 ? OptionDouble_none() : OptionDouble_some(sqrt(number));
+}
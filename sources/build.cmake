@@ -3,5 +3,18 @@ message("${ARCHIVE_NAME}@${CMAKE_CURRENT_LIST_DIR} using: ${CMAKE_CURRENT_LIST_F
 
 file(GLOB ARCHIVE_HEADERS ${CMAKE_CURRENT_LIST_DIR}/*.h)
 file(GLOB ARCHIVE_SOURCES ${CMAKE_CURRENT_LIST_DIR}/*.c)
+find_package(Threads REQUIRED)
+
 add_library(${ARCHIVE_NAME} ${ARCHIVE_HEADERS} ${ARCHIVE_SOURCES})
-target_link_libraries(${ARCHIVE_NAME} PRIVATE panic)
+target_link_libraries(${ARCHIVE_NAME} PUBLIC Threads::Threads PRIVATE panic)
+add_library(${ARCHIVE_NAME}-checked ALIAS ${ARCHIVE_NAME})
+
+# unchecked variant: contract checks are compiled into optimizer hints, link-compatible with the checked one
+add_library(${ARCHIVE_NAME}-fast ${ARCHIVE_HEADERS} ${ARCHIVE_SOURCES})
+target_compile_definitions(${ARCHIVE_NAME}-fast PUBLIC OPTION_UNCHECKED PRIVATE NDEBUG)
+target_link_libraries(${ARCHIVE_NAME}-fast PUBLIC Threads::Threads PRIVATE panic)
+
+# header-only variant: every function is defined `static inline` in option.h
+add_library(${ARCHIVE_NAME}-header-only INTERFACE)
+target_compile_definitions(${ARCHIVE_NAME}-header-only INTERFACE OPTION_HEADER_ONLY)
+target_link_libraries(${ARCHIVE_NAME}-header-only INTERFACE panic)
@@ -0,0 +1,214 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <panic/panic.h>
+#include "option-contract.h"
+#include "option-arena.h"
+
+// max_align_t is C11
+typedef union {
+    long double d;
+    long long l;
+    void *p;
+    void (*f)(void);
+} MaxAlign;
+
+typedef struct Chunk {
+    struct Chunk *next;
+    size_t capacity;
+    size_t used;
+    MaxAlign data[];
+} Chunk;
+
+struct OptionArena {
+    Chunk *head;
+    Chunk *current;
+    size_t capacity;
+};
+
+static pthread_key_t threadKey;
+static pthread_once_t threadKeyOnce = PTHREAD_ONCE_INIT;
+static __thread OptionArena *threadArena = NULL;
+
+static Chunk *Chunk_new(size_t capacity)
+__attribute__((__returns_nonnull__));
+
+static void *allocSlow(OptionArena *self, size_t size, size_t alignment)
+__attribute__((__noinline__, __returns_nonnull__));
+
+static void createThreadKey(void);
+
+static void deleteThreadArena(void *arena);
+
+static void deleteExitingArena(void);
+
+OptionArena *OptionArena_new(const size_t capacity) {
+    OptionArena *self = malloc(sizeof(*self));
+    Panic_when(NULL == self);
+    self->capacity = 0 == capacity ? 4096 : capacity;
+    self->head = self->current = Chunk_new(self->capacity);
+    return self;
+}
+
+void OptionArena_delete(OptionArena *const self) {
+    if (NULL != self) {
+        for (Chunk *chunk = self->head, *next; NULL != chunk; chunk = next) {
+            next = chunk->next;
+            free(chunk);
+        }
+        free(self);
+    }
+}
+
+OptionArena *OptionArena_thread(void) {
+    if (__builtin_expect(NULL == threadArena, 0)) {
+        Panic_unless(0 == pthread_once(&threadKeyOnce, createThreadKey));
+        threadArena = OptionArena_new(0);
+        // the key is only used to delete the arena when the thread exits
+        Panic_unless(0 == pthread_setspecific(threadKey, threadArena));
+    }
+    return threadArena;
+}
+
+void *OptionArena_alloc(OptionArena *const self, const size_t size, const size_t alignment) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(0 == alignment || 0 != (alignment & (alignment - 1)));
+    Chunk *const chunk = self->current;
+    const uintptr_t base = (uintptr_t) chunk->data;
+    const uintptr_t start = (base + chunk->used + alignment - 1) & ~(uintptr_t) (alignment - 1);
+    if (__builtin_expect(start + size <= base + chunk->capacity && start + size >= start, 1)) {
+        chunk->used = start + size - base;
+        return (void *) start;
+    }
+    return allocSlow(self, size, alignment);
+}
+
+OptionArenaMark OptionArena_mark(const OptionArena *const self) {
+    __Option_panicWhen(NULL == self);
+    return (OptionArenaMark) {.__chunk=self->current, .__used=self->current->used};
+}
+
+void OptionArena_rewind(OptionArena *const self, const OptionArenaMark mark) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(NULL == mark.__chunk);
+    self->current = mark.__chunk;
+    self->current->used = mark.__used;
+}
+
+void OptionArena_reset(OptionArena *const self) {
+    __Option_panicWhen(NULL == self);
+    self->current = self->head;
+    self->current->used = 0;
+}
+
+size_t OptionArena_used(const OptionArena *const self) {
+    __Option_panicWhen(NULL == self);
+    size_t used = 0;
+    for (const Chunk *chunk = self->head; chunk != self->current; chunk = chunk->next) {
+        used += chunk->used;
+    }
+    return used + self->current->used;
+}
+
+Option OptionArena_map(OptionArena *const self, const Option option, const size_t size,
+                       bool (*const f)(void *, const void *)) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(NULL == f);
+    if (Option_isNone(option)) {
+        return None;
+    }
+    const OptionArenaMark mark = OptionArena_mark(self);
+    void *const result = OptionArena_alloc(self, size, __alignof__(MaxAlign));
+    if (f(result, option.__value)) {
+        return Option_some(result);
+    }
+    OptionArena_rewind(self, mark);
+    return None;
+}
+
+Option OptionArena_chain(OptionArena *const self, const Option option, Option (*const f)(OptionArena *, const void *)) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(NULL == f);
+    if (Option_isNone(option)) {
+        return None;
+    }
+    const OptionArenaMark mark = OptionArena_mark(self);
+    const Option result = f(self, option.__value);
+    if (Option_isNone(result)) {
+        OptionArena_rewind(self, mark);
+    }
+    return result;
+}
+
+/*
+ *
+ */
+Chunk *Chunk_new(const size_t capacity) {
+    Chunk *self = malloc(sizeof(*self) + capacity);
+    Panic_when(NULL == self);
+    self->next = NULL;
+    self->capacity = capacity;
+    self->used = 0;
+    return self;
+}
+
+void *allocSlow(OptionArena *const self, const size_t size, const size_t alignment) {
+    Panic_when(size > SIZE_MAX / 2 - alignment);
+    const size_t required = size + alignment;
+    Chunk *next = self->current->next;
+    if (NULL == next || next->capacity < required) {
+        // chunks released by a rewind are reused in order, a chunk too small for this request is skipped by
+        // inserting a new one in front of it
+        next = Chunk_new(required > self->capacity ? required : self->capacity);
+        next->next = self->current->next;
+        self->current->next = next;
+    }
+    next->used = 0;
+    self->current = next;
+    return OptionArena_alloc(self, size, alignment);
+}
+
+void createThreadKey(void) {
+    Panic_unless(0 == pthread_key_create(&threadKey, deleteThreadArena));
+    // key destructors do not run on exit, nor when main returns
+    Panic_unless(0 == atexit(deleteExitingArena));
+}
+
+void deleteThreadArena(void *const arena) {
+    OptionArena_delete(arena);
+    threadArena = NULL;
+}
+
+void deleteExitingArena(void) {
+    if (NULL != threadArena) {
+        Panic_unless(0 == pthread_setspecific(threadKey, NULL));
+        deleteThreadArena(threadArena);
+    }
+}
@@ -0,0 +1,147 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "option.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A bump allocator for the values wrapped by options: allocating is a pointer increment and everything allocated
+ * after a mark is released at once by rewinding to it.
+ * Memory is obtained in chunks that are kept across resets, so a warmed-up arena never calls `malloc`.
+ */
+typedef struct OptionArena OptionArena;
+
+/**
+ * A position in an `OptionArena`, allocations made after it are released by `OptionArena_rewind(...)`.
+ *
+ * @attention this struct must be treated as opaque therefore its members must not be accessed directly.
+ */
+typedef struct {
+    void *__chunk;
+    size_t __used;
+} OptionArenaMark;
+
+/**
+ * Creates a new `OptionArena` whose chunks hold at least capacity bytes.
+ * Panics if memory cannot be allocated.
+ */
+extern OptionArena *OptionArena_new(size_t capacity)
+__attribute__((__warn_unused_result__, __returns_nonnull__));
+
+/**
+ * Deletes this `OptionArena` and every value allocated in it.
+ */
+extern void OptionArena_delete(OptionArena *self);
+
+/**
+ * Returns the `OptionArena` of the calling thread, created on first use and deleted when the thread exits.
+ * The arena of the thread calling `exit`, main included when it returns, is deleted by an `atexit` handler
+ * registered on first use.
+ * Panics if memory cannot be allocated.
+ *
+ * @attention values allocated in the arena must not be used by `atexit` handlers registered before its first use.
+ */
+extern OptionArena *OptionArena_thread(void)
+__attribute__((__warn_unused_result__, __returns_nonnull__));
+
+/**
+ * Allocates size bytes aligned to alignment.
+ * Panics if memory cannot be allocated.
+ *
+ * @attention self must not be `NULL`.
+ * @attention alignment must be a power of 2.
+ */
+extern void *OptionArena_alloc(OptionArena *self, size_t size, size_t alignment)
+__attribute__((__warn_unused_result__, __returns_nonnull__, __alloc_size__(2), __alloc_align__(3)));
+
+/**
+ * Returns the current position of this `OptionArena`.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern OptionArenaMark OptionArena_mark(const OptionArena *self)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Releases every allocation made after mark.
+ *
+ * @attention self must not be `NULL`.
+ * @attention mark must have been taken on this `OptionArena` and not have been released by a previous rewind or reset.
+ */
+extern void OptionArena_rewind(OptionArena *self, OptionArenaMark mark);
+
+/**
+ * Releases every allocation of this `OptionArena`, keeping its chunks for reuse.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern void OptionArena_reset(OptionArena *self);
+
+/**
+ * Returns the number of bytes currently allocated, alignment padding included.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern size_t OptionArena_used(const OptionArena *self)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Arena-aware `Option_map(...)`: if option is wrapping a value, f is called with a slot of size bytes allocated
+ * in this `OptionArena` (suitably aligned for any type) and returns `true` if it stored its result in it.
+ * Returns an `Option` wrapping the slot, or `None` if option is `None` or f returns `false`;
+ * in the latter case the slot is released.
+ *
+ * @attention self must not be `NULL`.
+ * @attention f must not be `NULL`.
+ */
+extern Option OptionArena_map(OptionArena *self, Option option, size_t size, bool f(void *result, const void *value))
+__attribute__((__warn_unused_result__));
+
+/**
+ * Arena-aware `Option_chain(...)`: f may allocate in this `OptionArena`,
+ * if it returns `None` every allocation made by f is released.
+ *
+ * @attention self must not be `NULL`.
+ * @attention f must not be `NULL`.
+ */
+extern Option OptionArena_chain(OptionArena *self, Option option, Option f(OptionArena *arena, const void *value))
+__attribute__((__warn_unused_result__));
+
+#ifdef __cplusplus
+}
+#endif
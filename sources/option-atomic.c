@@ -0,0 +1,205 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <sched.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <panic/panic.h>
+#include "option-contract.h"
+#include "option-atomic.h"
+
+#define CACHE_LINE          64
+#define RETIRED_CAPACITY    128     // values retired per thread before scanning
+
+struct OptionHazard {
+    const void *value;
+    OptionHazard *next;         // every hazard ever acquired, never unlinked
+    bool active;
+} __attribute__((__aligned__(CACHE_LINE)));
+
+typedef struct Retired {
+    void *value;
+    void (*reclaim)(void *);
+} Retired;
+
+/*
+ * The values retired by a thread: allocated on its first retire and kept for its whole life, then parked in
+ * globalBags with the values still pending, to be adopted by the next thread that retires.
+ */
+typedef struct Bag {
+    struct Bag *next;
+    size_t count;
+    Retired retired[RETIRED_CAPACITY];
+} Bag;
+
+static OptionHazard *globalHazards = NULL;
+static Bag *globalBags = NULL;                  // bags of exited threads, a lock-free stack
+
+static pthread_key_t threadKey;
+static pthread_once_t threadKeyOnce = PTHREAD_ONCE_INIT;
+static __thread Bag *threadBag = NULL;
+
+static Bag *attachBag(void)
+__attribute__((__noinline__, __returns_nonnull__));
+
+static void detachBag(void *bag);
+
+static void createThreadKey(void);
+
+static size_t scan(Bag *bag);
+
+static bool isProtected(const OptionHazard *hazards, const void *value);
+
+Option AtomicOption_protect(const AtomicOption *const self, OptionHazard *const hazard) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(NULL == hazard);
+    const void *value = __atomic_load_n(&self->__value, __ATOMIC_RELAXED);
+    for (;;) {
+        // the value is safe once it is still current after the hazard has been published
+        __atomic_store_n(&hazard->value, value, __ATOMIC_SEQ_CST);
+        const void *const current = __atomic_load_n(&self->__value, __ATOMIC_SEQ_CST);
+        if (current == value) {
+            return (Option) {.__value=value};
+        }
+        value = current;
+    }
+}
+
+OptionHazard *OptionHazard_acquire(void) {
+    for (OptionHazard *hazard = __atomic_load_n(&globalHazards, __ATOMIC_ACQUIRE); NULL != hazard;
+         hazard = hazard->next) {
+        bool active = false;
+        if (!__atomic_load_n(&hazard->active, __ATOMIC_RELAXED) &&
+            __atomic_compare_exchange_n(&hazard->active, &active, true, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return hazard;
+        }
+    }
+
+    OptionHazard *hazard = NULL;
+    Panic_unless(0 == posix_memalign((void **) &hazard, CACHE_LINE, sizeof(*hazard)));
+    hazard->value = NULL;
+    hazard->active = true;
+    hazard->next = __atomic_load_n(&globalHazards, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&globalHazards, &hazard->next, hazard, true,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    return hazard;
+}
+
+void OptionHazard_clear(OptionHazard *const hazard) {
+    __Option_panicWhen(NULL == hazard);
+    __atomic_store_n(&hazard->value, NULL, __ATOMIC_RELEASE);
+}
+
+void OptionHazard_release(OptionHazard *const hazard) {
+    OptionHazard_clear(hazard);
+    __atomic_store_n(&hazard->active, false, __ATOMIC_RELEASE);
+}
+
+void OptionHazard_retire(void *const value, void (*const reclaim)(void *)) {
+    __Option_panicWhen(NULL == value);
+    __Option_panicWhen(NULL == reclaim);
+    Bag *const bag = __builtin_expect(NULL != threadBag, 1) ? threadBag : attachBag();
+    // a bag still full after a scan means that every value in it is protected: wait for the readers to move on
+    while (RETIRED_CAPACITY == bag->count && RETIRED_CAPACITY == scan(bag)) {
+        sched_yield();
+    }
+    bag->retired[bag->count++] = (Retired) {.value=value, .reclaim=reclaim};
+}
+
+size_t OptionHazard_scan(void) {
+    return NULL == threadBag ? 0 : scan(threadBag);
+}
+
+/*
+ *
+ */
+Bag *attachBag(void) {
+    Panic_unless(0 == pthread_once(&threadKeyOnce, createThreadKey));
+    // adopt the bag of an exited thread if any: take the whole stack and push back the others
+    Bag *bag = __atomic_exchange_n(&globalBags, NULL, __ATOMIC_ACQUIRE);
+    if (NULL != bag) {
+        for (Bag *other = bag->next, *next; NULL != other; other = next) {
+            next = other->next;
+            other->next = __atomic_load_n(&globalBags, __ATOMIC_RELAXED);
+            while (!__atomic_compare_exchange_n(&globalBags, &other->next, other, true,
+                                                __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+        }
+    } else {
+        bag = malloc(sizeof(*bag));
+        Panic_when(NULL == bag);
+        bag->count = 0;
+    }
+    bag->next = NULL;
+    // the key is only used to park the bag when the thread exits
+    Panic_unless(0 == pthread_setspecific(threadKey, bag));
+    threadBag = bag;
+    return bag;
+}
+
+void detachBag(void *const bag) {
+    Bag *const self = bag;
+    scan(self);
+    self->next = __atomic_load_n(&globalBags, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&globalBags, &self->next, self, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    threadBag = NULL;
+}
+
+void createThreadKey(void) {
+    Panic_unless(0 == pthread_key_create(&threadKey, detachBag));
+}
+
+/*
+ * Reclaims the values of bag that no hazard protects, returns the number of values still pending.
+ * Costs retired values times hazards comparisons, without allocations.
+ */
+size_t scan(Bag *const bag) {
+    // pairs with the store in AtomicOption_protect: a hazard published before the value was unlinked is seen here
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    // hazards are pushed at the head of the list: the ones older than head are all reached from it
+    const OptionHazard *const hazards = __atomic_load_n(&globalHazards, __ATOMIC_ACQUIRE);
+    size_t pending = 0;
+    for (size_t i = 0; i < bag->count; i++) {
+        const Retired retired = bag->retired[i];
+        if (isProtected(hazards, retired.value)) {
+            bag->retired[pending++] = retired;
+        } else {
+            retired.reclaim(retired.value);
+        }
+    }
+    bag->count = pending;
+    return pending;
+}
+
+bool isProtected(const OptionHazard *hazards, const void *const value) {
+    for (; NULL != hazards; hazards = hazards->next) {
+        if (value == __atomic_load_n(&hazards->value, __ATOMIC_SEQ_CST)) {
+            return true;
+        }
+    }
+    return false;
+}
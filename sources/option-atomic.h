@@ -0,0 +1,211 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include "option.h"
+#include "option-contract.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * An `Option` that can be shared between threads without locks: `Option` is a single pointer, so every operation
+ * is a single atomic instruction on it.
+ *
+ * Operations are defined `static inline` and take explicit memory orders, which must be compile-time constants
+ * for the compiler to honour them (a non-constant order is treated as `OptionMemoryOrder_seqCst`).
+ *
+ * Values removed with `AtomicOption_take(...)`, `AtomicOption_replace(...)` or `AtomicOption_compareExchange(...)`
+ * are owned by the caller. Threads that dereference values they do not own must read them through
+ * `AtomicOption_protect(...)` and owners must free them through `OptionHazard_retire(...)`.
+ *
+ * @attention this struct must be treated as opaque therefore its members must not be accessed directly.
+ */
+typedef struct AtomicOption {
+    const void *__value;
+} AtomicOption;
+
+/**
+ * A hazard pointer: while it protects a value, that value is not reclaimed by `OptionHazard_retire(...)`.
+ * Each thread acquires its own hazards and must not share them.
+ *
+ * @attention this struct must be treated as opaque.
+ */
+typedef struct OptionHazard OptionHazard;
+
+/**
+ * Memory orders of `AtomicOption` operations, with the semantics of the C11 ones.
+ */
+typedef enum OptionMemoryOrder {
+    OptionMemoryOrder_relaxed = __ATOMIC_RELAXED,
+    OptionMemoryOrder_acquire = __ATOMIC_ACQUIRE,
+    OptionMemoryOrder_release = __ATOMIC_RELEASE,
+    OptionMemoryOrder_acqRel = __ATOMIC_ACQ_REL,
+    OptionMemoryOrder_seqCst = __ATOMIC_SEQ_CST,
+} OptionMemoryOrder;
+
+/**
+ * Static initializer of an `AtomicOption` holding `None`.
+ */
+#define ATOMIC_OPTION_INIT \
+    {.__value=NULL}
+
+/**
+ * Returns the value of this `AtomicOption`.
+ *
+ * @attention self must not be `NULL`.
+ * @attention order must not be `OptionMemoryOrder_release` or `OptionMemoryOrder_acqRel`.
+ */
+__attribute__((__always_inline__, __warn_unused_result__))
+static inline Option AtomicOption_load(const AtomicOption *const self, const OptionMemoryOrder order) {
+    __Option_panicWhen(NULL == self);
+    return (Option) {.__value=__atomic_load_n(&self->__value, order)};
+}
+
+/**
+ * Sets the value of this `AtomicOption` to option.
+ *
+ * @attention self must not be `NULL`.
+ * @attention order must not be `OptionMemoryOrder_acquire` or `OptionMemoryOrder_acqRel`.
+ */
+__attribute__((__always_inline__))
+static inline void AtomicOption_store(AtomicOption *const self, const Option option, const OptionMemoryOrder order) {
+    __Option_panicWhen(NULL == self);
+    __atomic_store_n(&self->__value, option.__value, order);
+}
+
+/**
+ * Sets the value of this `AtomicOption` to option returning the previous one.
+ *
+ * @attention self must not be `NULL`.
+ */
+__attribute__((__always_inline__, __warn_unused_result__))
+static inline Option AtomicOption_replace(AtomicOption *const self, const Option option,
+                                          const OptionMemoryOrder order) {
+    __Option_panicWhen(NULL == self);
+    return (Option) {.__value=__atomic_exchange_n(&self->__value, option.__value, order)};
+}
+
+/**
+ * Sets the value of this `AtomicOption` to `None` returning the previous one.
+ * Only one of the threads taking concurrently gets a given value.
+ *
+ * @attention self must not be `NULL`.
+ */
+__attribute__((__always_inline__, __warn_unused_result__))
+static inline Option AtomicOption_take(AtomicOption *const self, const OptionMemoryOrder order) {
+    return AtomicOption_replace(self, None, order);
+}
+
+/**
+ * Sets the value of this `AtomicOption` to desired if it is *expected and returns `true`,
+ * otherwise stores the current value in *expected and returns `false`.
+ *
+ * @attention self must not be `NULL`.
+ * @attention expected must not be `NULL`.
+ * @attention failure must not be `OptionMemoryOrder_release` or `OptionMemoryOrder_acqRel`
+ *  and must not be stronger than success.
+ */
+__attribute__((__always_inline__, __warn_unused_result__))
+static inline bool AtomicOption_compareExchange(AtomicOption *const self, Option *const expected, const Option desired,
+                                                const OptionMemoryOrder success, const OptionMemoryOrder failure) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(NULL == expected);
+    return __atomic_compare_exchange_n(&self->__value, &expected->__value, desired.__value, false, success, failure);
+}
+
+/**
+ * Sets the value of this `AtomicOption` to option if it is `None`, returns `true` on success `false` otherwise.
+ *
+ * @attention self must not be `NULL`.
+ */
+__attribute__((__always_inline__, __warn_unused_result__))
+static inline bool AtomicOption_putIfNone(AtomicOption *const self, const Option option,
+                                          const OptionMemoryOrder order) {
+    Option expected = None;
+    return AtomicOption_compareExchange(self, &expected, option, order, OptionMemoryOrder_relaxed);
+}
+
+/**
+ * Returns the value of this `AtomicOption` after publishing it in hazard, so that it is not reclaimed until hazard
+ * protects something else or is cleared.
+ *
+ * @attention self must not be `NULL`.
+ * @attention hazard must not be `NULL`.
+ */
+extern Option AtomicOption_protect(const AtomicOption *self, OptionHazard *hazard)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Returns a hazard for the calling thread, reusing a released one if possible.
+ * Hazards are never freed: their number is bounded by the number of hazards held at the same time.
+ */
+extern OptionHazard *OptionHazard_acquire(void)
+__attribute__((__warn_unused_result__, __returns_nonnull__));
+
+/**
+ * Stops protecting the value protected by hazard, if any.
+ *
+ * @attention hazard must not be `NULL`.
+ */
+extern void OptionHazard_clear(OptionHazard *hazard);
+
+/**
+ * Clears hazard and makes it available to `OptionHazard_acquire(...)`.
+ *
+ * @attention hazard must not be `NULL` and must not be used afterwards.
+ */
+extern void OptionHazard_release(OptionHazard *hazard);
+
+/**
+ * Schedules reclaim(value) to run once no hazard protects value anymore.
+ * Retired values are kept in a fixed-size per-thread buffer, allocated on the first retire of the thread, and scanned
+ * once it is full: retiring neither allocates nor locks afterwards. If every buffered value is still protected,
+ * retiring yields until one is released. Values still pending when the thread exits are handed to the next thread
+ * that retires for the first time.
+ *
+ * @attention value must not be `NULL` and must be unreachable from any `AtomicOption`.
+ * @attention reclaim must not be `NULL`.
+ */
+extern void OptionHazard_retire(void *value, void reclaim(void *));
+
+/**
+ * Reclaims the values retired by the calling thread that are not protected anymore,
+ * returns the number of values still pending.
+ */
+extern size_t OptionHazard_scan(void);
+
+#ifdef __cplusplus
+}
+#endif
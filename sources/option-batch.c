@@ -0,0 +1,319 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include <panic/panic.h>
+#include "option-contract.h"
+#include "option-batch.h"
+
+#if defined(__x86_64__)
+#define OPTION_BATCH_X86_64 1
+#include <immintrin.h>
+#endif
+
+typedef struct {
+    const char *name;
+    size_t (*countSome)(const Option *items, size_t length);
+    size_t (*findNone)(const Option *items, size_t length);
+    void (*maskSome)(const Option *items, size_t length, uint64_t *mask);
+    size_t (*compactSome)(const Option *items, size_t length, const void **values);
+} Kernels;
+
+static const Kernels *globalKernels = NULL;
+
+static const Kernels *kernels(void)
+__attribute__((__returns_nonnull__));
+
+static const Kernels *supportedKernels(const char *name)
+__attribute__((__nonnull__));
+
+size_t Option_countSome(const Option *const items, const size_t length) {
+    __Option_panicWhen(NULL == items && 0 < length);
+    return kernels()->countSome(items, length);
+}
+
+size_t Option_findNone(const Option *const items, const size_t length) {
+    __Option_panicWhen(NULL == items && 0 < length);
+    return kernels()->findNone(items, length);
+}
+
+void Option_maskSome(const Option *const items, const size_t length, uint64_t *const mask) {
+    __Option_panicWhen(NULL == items && 0 < length);
+    __Option_panicWhen(NULL == mask);
+    kernels()->maskSome(items, length, mask);
+}
+
+size_t Option_compactSome(const Option *const items, const size_t length, const void **const values) {
+    __Option_panicWhen(NULL == items && 0 < length);
+    __Option_panicWhen(NULL == values);
+    return kernels()->compactSome(items, length, values);
+}
+
+const char *Option_batchKernels(void) {
+    return kernels()->name;
+}
+
+bool __Option_forceBatchKernels(const char *const name) {
+    const Kernels *const forced = NULL == name ? NULL : supportedKernels(name);
+    if (NULL != name && NULL == forced) {
+        return false;
+    }
+    // NULL makes the next call select again
+    __atomic_store_n(&globalKernels, forced, __ATOMIC_RELEASE);
+    return true;
+}
+
+/*
+ * Scalar kernels, also used to process the tails left over by the vector kernels.
+ */
+static size_t scalarCountSome(const Option *const items, const size_t length) {
+    size_t count = 0;
+    for (size_t i = 0; i < length; i++) {
+        count += NULL != items[i].__value;
+    }
+    return count;
+}
+
+static size_t scalarFindNone(const Option *const items, const size_t length) {
+    size_t i = 0;
+    while (i < length && NULL != items[i].__value) {
+        i++;
+    }
+    return i;
+}
+
+static void scalarMaskSomeFrom(const Option *const items, size_t i, const size_t length, uint64_t *const mask) {
+    for (; i < length; i++) {
+        mask[i / 64] |= (uint64_t) (NULL != items[i].__value) << (i % 64);
+    }
+}
+
+static void scalarMaskSome(const Option *const items, const size_t length, uint64_t *const mask) {
+    memset(mask, 0, ((length + 63) / 64) * sizeof(mask[0]));
+    scalarMaskSomeFrom(items, 0, length, mask);
+}
+
+static size_t scalarCompactSome(const Option *const items, const size_t length, const void **const values) {
+    size_t count = 0;
+    for (size_t i = 0; i < length; i++) {
+        // branchless: values has room for length values so the slot at count can always be written
+        values[count] = items[i].__value;
+        count += NULL != items[i].__value;
+    }
+    return count;
+}
+
+static const Kernels scalarKernels = {
+        .name="scalar",
+        .countSome=scalarCountSome,
+        .findNone=scalarFindNone,
+        .maskSome=scalarMaskSome,
+        .compactSome=scalarCompactSome,
+};
+
+#if defined(OPTION_BATCH_X86_64)
+
+/*
+ * Generates the vector kernels of an instruction set, given:
+ *  - width: the number of items processed per step, must be a divisor of 64;
+ *  - someMask(block): returns the presence bitmask of width items;
+ *  - compact(block, mask, values): stores the values of the items selected by mask, returns how many were stored.
+ */
+#define KERNELS(isa, target, width, someMask, compact)                                                                 \
+    __attribute__((__target__(target)))                                                                                \
+    static size_t isa##CountSome(const Option *const items, const size_t length) {                                     \
+        size_t count = 0, i = 0;                                                                                       \
+        for (; i + (width) <= length; i += (width)) {                                                                  \
+            count += (size_t) __builtin_popcountll(someMask(items + i));                                               \
+        }                                                                                                              \
+        return count + scalarCountSome(items + i, length - i);                                                         \
+    }                                                                                                                  \
+                                                                                                                       \
+    __attribute__((__target__(target)))                                                                                \
+    static size_t isa##FindNone(const Option *const items, const size_t length) {                                      \
+        const uint64_t full = (UINT64_C(1) << (width)) - 1;                                                            \
+        size_t i = 0;                                                                                                  \
+        for (; i + (width) <= length; i += (width)) {                                                                  \
+            const uint64_t mask = someMask(items + i);                                                                 \
+            if (full != mask) {                                                                                        \
+                return i + (size_t) __builtin_ctzll(~mask);                                                            \
+            }                                                                                                          \
+        }                                                                                                              \
+        return i + scalarFindNone(items + i, length - i);                                                              \
+    }                                                                                                                  \
+                                                                                                                       \
+    __attribute__((__target__(target)))                                                                                \
+    static void isa##MaskSome(const Option *const items, const size_t length, uint64_t *const mask) {                  \
+        size_t i = 0;                                                                                                  \
+        memset(mask, 0, ((length + 63) / 64) * sizeof(mask[0]));                                                       \
+        for (; i + (width) <= length; i += (width)) {                                                                  \
+            mask[i / 64] |= someMask(items + i) << (i % 64);                                                           \
+        }                                                                                                              \
+        scalarMaskSomeFrom(items, i, length, mask);                                                                    \
+    }                                                                                                                  \
+                                                                                                                       \
+    __attribute__((__target__(target)))                                                                                \
+    static size_t isa##CompactSome(const Option *const items, const size_t length, const void **const values) {        \
+        size_t count = 0, i = 0;                                                                                       \
+        for (; i + (width) <= length; i += (width)) {                                                                  \
+            count += compact(items + i, someMask(items + i), values + count);                                          \
+        }                                                                                                              \
+        return count + scalarCompactSome(items + i, length - i, values + count);                                       \
+    }                                                                                                                  \
+                                                                                                                       \
+    static const Kernels isa##Kernels = {                                                                              \
+            .name=#isa,                                                                                                \
+            .countSome=isa##CountSome,                                                                                 \
+            .findNone=isa##FindNone,                                                                                   \
+            .maskSome=isa##MaskSome,                                                                                   \
+            .compactSome=isa##CompactSome,                                                                             \
+    };
+
+static inline size_t compactBits(const Option *const block, uint64_t mask, const void **const values) {
+    size_t count = 0;
+    while (0 != mask) {
+        values[count++] = block[__builtin_ctzll(mask)].__value;
+        mask &= mask - 1;
+    }
+    return count;
+}
+
+/*
+ * SSE2: 2 items per register, SSE2 lacks 64-bit compares so both 32-bit halves must compare equal to zero.
+ */
+__attribute__((__target__("sse2")))
+static inline uint64_t sse2SomeMask2(const Option *const block) {
+    const __m128i equal = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *) block), _mm_setzero_si128());
+    const __m128i none = _mm_and_si128(equal, _mm_shuffle_epi32(equal, _MM_SHUFFLE(2, 3, 0, 1)));
+    return ~(uint64_t) _mm_movemask_pd(_mm_castsi128_pd(none)) & 0x3;
+}
+
+__attribute__((__target__("sse2")))
+static inline uint64_t sse2SomeMask(const Option *const block) {
+    return sse2SomeMask2(block) | sse2SomeMask2(block + 2) << 2 |
+           sse2SomeMask2(block + 4) << 4 | sse2SomeMask2(block + 6) << 6;
+}
+
+KERNELS(sse2, "sse2", 8, sse2SomeMask, compactBits)
+
+/*
+ * AVX2: 4 items per register.
+ */
+__attribute__((__target__("avx2")))
+static inline uint64_t avx2SomeMask4(const Option *const block) {
+    const __m256i none = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *) block), _mm256_setzero_si256());
+    return ~(uint64_t) _mm256_movemask_pd(_mm256_castsi256_pd(none)) & 0xF;
+}
+
+__attribute__((__target__("avx2")))
+static inline uint64_t avx2SomeMask(const Option *const block) {
+    return avx2SomeMask4(block) | avx2SomeMask4(block + 4) << 4 |
+           avx2SomeMask4(block + 8) << 8 | avx2SomeMask4(block + 12) << 12;
+}
+
+KERNELS(avx2, "avx2", 16, avx2SomeMask, compactBits)
+
+/*
+ * AVX-512: 8 items per register, compaction is done by compress-store.
+ */
+__attribute__((__target__("avx512f")))
+static inline uint64_t avx512SomeMask8(const Option *const block) {
+    const __m512i items = _mm512_loadu_si512((const void *) block);
+    return _mm512_test_epi64_mask(items, items);
+}
+
+__attribute__((__target__("avx512f")))
+static inline uint64_t avx512SomeMask(const Option *const block) {
+    return avx512SomeMask8(block) | avx512SomeMask8(block + 8) << 8 |
+           avx512SomeMask8(block + 16) << 16 | avx512SomeMask8(block + 24) << 24;
+}
+
+__attribute__((__target__("avx512f")))
+static inline size_t avx512Compact(const Option *const block, const uint64_t mask, const void **const values) {
+    size_t count = 0;
+    for (size_t i = 0; i < 32; i += 8) {
+        const __mmask8 lanes = (__mmask8) (mask >> i);
+        const __m512i items = _mm512_loadu_si512((const void *) (block + i));
+        _mm512_mask_compressstoreu_epi64((void *) (values + count), lanes, items);
+        count += (size_t) __builtin_popcount(lanes);
+    }
+    return count;
+}
+
+KERNELS(avx512, "avx512f", 32, avx512SomeMask, avx512Compact)
+
+#undef KERNELS
+
+const Kernels *supportedKernels(const char *const name) {
+    __builtin_cpu_init();
+    if (0 == strcmp(name, avx512Kernels.name)) {
+        return __builtin_cpu_supports("avx512f") ? &avx512Kernels : NULL;
+    }
+    if (0 == strcmp(name, avx2Kernels.name)) {
+        return __builtin_cpu_supports("avx2") ? &avx2Kernels : NULL;
+    }
+    if (0 == strcmp(name, sse2Kernels.name)) {
+        return __builtin_cpu_supports("sse2") ? &sse2Kernels : NULL;
+    }
+    return 0 == strcmp(name, scalarKernels.name) ? &scalarKernels : NULL;
+}
+
+static const Kernels *selectKernels(void) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return &avx512Kernels;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return &avx2Kernels;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return &sse2Kernels;
+    }
+    return &scalarKernels;
+}
+
+#else
+
+const Kernels *supportedKernels(const char *const name) {
+    return 0 == strcmp(name, scalarKernels.name) ? &scalarKernels : NULL;
+}
+
+static const Kernels *selectKernels(void) {
+    return &scalarKernels;
+}
+
+#endif
+
+const Kernels *kernels(void) {
+    const Kernels *result = __atomic_load_n(&globalKernels, __ATOMIC_ACQUIRE);
+    if (__builtin_expect(NULL == result, 0)) {
+        // selection is idempotent, concurrent first calls may race harmlessly
+        result = selectKernels();
+        __atomic_store_n(&globalKernels, result, __ATOMIC_RELEASE);
+    }
+    return result;
+}
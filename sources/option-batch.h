@@ -0,0 +1,98 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "option.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Batch kernels operating on arrays of `Option`.
+ * On x86 the best available implementation among AVX-512, AVX2 and SSE2 is selected at runtime,
+ * elsewhere a portable scalar implementation is used.
+ */
+
+/**
+ * Returns the number of items wrapping a value.
+ *
+ * @attention items must not be `NULL` unless length is 0.
+ */
+extern size_t Option_countSome(const Option *items, size_t length)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Returns the index of the first `None` in items, or length if every item is wrapping a value.
+ *
+ * @attention items must not be `NULL` unless length is 0.
+ */
+extern size_t Option_findNone(const Option *items, size_t length)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Builds the presence bitmask of items: bit `i % 64` of `mask[i / 64]` is set if `items[i]` is wrapping a value.
+ *
+ * @attention items must not be `NULL` unless length is 0.
+ * @attention mask must not be `NULL` and must have room for `(length + 63) / 64` words.
+ */
+extern void Option_maskSome(const Option *items, size_t length, uint64_t *mask);
+
+/**
+ * Copies the values of the items wrapping a value into values, preserving their order.
+ * Returns the number of values written.
+ *
+ * @attention items must not be `NULL` unless length is 0.
+ * @attention values must not be `NULL` and must have room for length values.
+ */
+extern size_t Option_compactSome(const Option *items, size_t length, const void **values);
+
+/**
+ * Returns the name of the kernels selected at runtime, e.g. "avx2".
+ */
+extern const char *Option_batchKernels(void)
+__attribute__((__warn_unused_result__, __returns_nonnull__));
+
+/**
+ * Forces the kernels named name, e.g. "sse2", so that every implementation can be tested on the same CPU;
+ * `NULL` restores the runtime selection.
+ * Returns `false`, leaving the selection unchanged, if name is unknown or not supported by the CPU.
+ *
+ * @attention this function must be treated as opaque therefore should not be called directly.
+ */
+extern bool __Option_forceBatchKernels(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
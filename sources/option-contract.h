@@ -0,0 +1,51 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <panic/panic.h>
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+/**
+ * Checks a contract of this library (the `@attention` clauses of its documentation) panicking when violated.
+ *
+ * When `OPTION_UNCHECKED` is defined the check is compiled into a `__builtin_unreachable` hint the optimizer can
+ * exploit instead, and violating the contract is undefined behaviour.
+ * Failures that do not depend on the caller, like running out of memory, must use `Panic_when` directly.
+ *
+ * @attention this macro must be treated as opaque therefore must not be used outside this library.
+ */
+#if defined(OPTION_UNCHECKED)
+#define __Option_panicWhen(condition) \
+    ((condition) ? __builtin_unreachable() : (void) 0)
+#else
+#define __Option_panicWhen(condition) \
+    Panic_when(condition)
+#endif
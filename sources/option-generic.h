@@ -0,0 +1,116 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <limits.h>
+#include <stdint.h>
+#include "option.h"
+#include "option-contract.h"
+
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 201112L
+#error "option-generic.h requires C11"
+#endif
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#if SIZE_MAX != UINT_MAX
+#define __OPTION_GENERIC_SIZE(X)    X(size_t, Size)
+#else
+#define __OPTION_GENERIC_SIZE(X)
+#endif
+
+/**
+ * Type-safe front-end of `Option_map(...)` and `Option_chain(...)`.
+ *
+ * After including this header, `Option_map(self, f)` and `Option_chain(self, f)` select with `_Generic` a `static inline`
+ * implementation specialized on the type of f, which calls f directly instead of through a `const void *` signature,
+ * so the compiler type-checks the callback and can inline it.
+ * For every registered pair (Type, Name) the accepted callbacks are:
+ *  - `const Type *f(const Type *)` for `Option_map(...)`
+ *  - `Option f(const Type *)` for `Option_chain(...)`
+ * Callbacks of any other type go to the generic implementations.
+ *
+ * The registry is an X-macro: `OPTION_GENERIC_TYPES(X)` lists the builtin pairs, additional pairs can be registered
+ * by defining `OPTION_GENERIC_USER_TYPES(X)` before including this header, e.g.
+ *
+ *      #define OPTION_GENERIC_USER_TYPES(X)    X(struct Point, Point)
+ *
+ * `size_t` is registered only where it is not `unsigned`, as on ILP32 targets it would be a duplicate association.
+ *
+ * @attention a type must not be registered twice.
+ */
+#define OPTION_GENERIC_TYPES(X)                                                                                        \
+    X(char, Char)                                                                                                      \
+    X(int, Int)                                                                                                        \
+    X(long, Long)                                                                                                      \
+    X(unsigned, Unsigned)                                                                                              \
+    __OPTION_GENERIC_SIZE(X)                                                                                           \
+    X(float, Float)                                                                                                    \
+    X(double, Double)
+
+#if !defined(OPTION_GENERIC_USER_TYPES)
+#define OPTION_GENERIC_USER_TYPES(X)
+#endif
+
+#define __OPTION_GENERIC_DEFINE(Type, Name)                                                                            \
+    __attribute__((__always_inline__, __warn_unused_result__))                                                         \
+    static inline Option __OptionGeneric_map##Name(const Option self, const Type *(*const f)(const Type *)) {          \
+        __Option_panicWhen(NULL == f);                                                                                 \
+        return NULL == self.__value ? self : (Option) {.__value=f((const Type *) self.__value)};                       \
+    }                                                                                                                  \
+                                                                                                                       \
+    __attribute__((__always_inline__, __warn_unused_result__))                                                         \
+    static inline Option __OptionGeneric_chain##Name(const Option self, Option (*const f)(const Type *)) {             \
+        __Option_panicWhen(NULL == f);                                                                                 \
+        return NULL == self.__value ? self : f((const Type *) self.__value);                                           \
+    }
+
+OPTION_GENERIC_TYPES(__OPTION_GENERIC_DEFINE)
+OPTION_GENERIC_USER_TYPES(__OPTION_GENERIC_DEFINE)
+
+#define __OPTION_GENERIC_MAP(Type, Name) \
+    const Type *(*)(const Type *): __OptionGeneric_map##Name,
+
+#define __OPTION_GENERIC_CHAIN(Type, Name) \
+    Option (*)(const Type *): __OptionGeneric_chain##Name,
+
+#undef Option_map
+#define Option_map(self, f)                                                                                            \
+    _Generic((f),                                                                                                      \
+        OPTION_GENERIC_TYPES(__OPTION_GENERIC_MAP)                                                                     \
+        OPTION_GENERIC_USER_TYPES(__OPTION_GENERIC_MAP)                                                                \
+        default: (Option_map))((self), (f))
+
+#undef Option_chain
+#define Option_chain(self, f)                                                                                          \
+    _Generic((f),                                                                                                      \
+        OPTION_GENERIC_TYPES(__OPTION_GENERIC_CHAIN)                                                                   \
+        OPTION_GENERIC_USER_TYPES(__OPTION_GENERIC_CHAIN)                                                              \
+        default: (Option_chain))((self), (f))
@@ -0,0 +1,417 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "option.h"
+#include "option-contract.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A pull-based iterator: `OptionIterator_next(...)` returns the next value wrapped in an `Option`,
+ * `None` once exhausted.
+ *
+ * Adaptors are lazy and are built in caller-provided storage (usually automatic variables): every value is pulled
+ * through the whole chain of adaptors before the next one is read, so a pipeline runs in constant memory
+ * without intermediate buffers or allocations.
+ *
+ *      OptionIterator source, evens, squares;
+ *      OptionIterator_fromArray(&source, items, length, sizeof(items[0]));
+ *      OptionIterator_filter(&evens, &source, isEven);
+ *      OptionIterator_map(&squares, &evens, square);
+ *
+ * Such chains are composed at runtime: every value goes through the `__next` pointer of each adaptor.
+ * Everything is defined `static inline` so the compiler can resolve the outermost pointers of a chain built in
+ * automatic storage, but in general a chain costs an indirect call per adaptor per value.
+ * Pipelines known at compile time fuse into a single loop with the `OptionIterator_for*` statement macros below.
+ *
+ * @attention this struct must be treated as opaque therefore its members must not be accessed directly.
+ */
+typedef struct OptionIterator OptionIterator;
+
+struct OptionIterator {
+    Option (*__next)(OptionIterator *self);
+    OptionIterator *__source;
+    OptionIterator *__other;
+    union {
+        Option (*generate)(void *context);
+        const void *(*map)(const void *value);
+        bool (*filter)(const void *value);
+        Option (*filterMap)(const void *value);
+        const void *(*zip)(const void *first, const void *second);
+    } __f;
+    void *__context;
+    const char *__cursor;
+    const char *__end;
+    size_t __size;
+    size_t __count;
+};
+
+/*
+ * The `__next` implementations of the sources and of the adaptors.
+ */
+static inline Option __OptionIterator_nextGenerated(OptionIterator *const self) {
+    return self->__f.generate(self->__context);
+}
+
+static inline Option __OptionIterator_nextElement(OptionIterator *const self) {
+    if (self->__cursor == self->__end) {
+        return (Option) {.__value=NULL};
+    }
+    const char *const element = self->__cursor;
+    self->__cursor += self->__size;
+    return (Option) {.__value=element};
+}
+
+static inline Option __OptionIterator_nextMapped(OptionIterator *const self) {
+    const Option value = self->__source->__next(self->__source);
+    return (NULL == value.__value) ? value : (Option) {.__value=self->__f.map(value.__value)};
+}
+
+static inline Option __OptionIterator_nextFiltered(OptionIterator *const self) {
+    OptionIterator *const source = self->__source;
+    for (Option value = source->__next(source); (NULL != value.__value); value = source->__next(source)) {
+        if (self->__f.filter(value.__value)) {
+            return value;
+        }
+    }
+    return (Option) {.__value=NULL};
+}
+
+static inline Option __OptionIterator_nextFilterMapped(OptionIterator *const self) {
+    OptionIterator *const source = self->__source;
+    for (Option value = source->__next(source); (NULL != value.__value); value = source->__next(source)) {
+        const Option result = self->__f.filterMap(value.__value);
+        if ((NULL != result.__value)) {
+            return result;
+        }
+    }
+    return (Option) {.__value=NULL};
+}
+
+static inline Option __OptionIterator_nextTaken(OptionIterator *const self) {
+    if (0 == self->__count) {
+        return (Option) {.__value=NULL};
+    }
+    self->__count--;
+    return self->__source->__next(self->__source);
+}
+
+static inline Option __OptionIterator_nextSkipped(OptionIterator *const self) {
+    OptionIterator *const source = self->__source;
+    for (; 0 < self->__count; self->__count--) {
+        if (NULL == source->__next(source).__value) {
+            self->__count = 0;
+            return (Option) {.__value=NULL};
+        }
+    }
+    return source->__next(source);
+}
+
+static inline Option __OptionIterator_nextZipped(OptionIterator *const self) {
+    const Option first = self->__source->__next(self->__source);
+    if ((NULL == first.__value)) {
+        return (Option) {.__value=NULL};
+    }
+    const Option second = self->__other->__next(self->__other);
+    return (NULL == second.__value) ? (Option) {.__value=NULL}
+                                    : (Option) {.__value=self->__f.zip(first.__value, second.__value)};
+}
+
+__attribute__((__always_inline__, __returns_nonnull__))
+static inline OptionIterator *__OptionIterator_adapt(OptionIterator *const self,
+                                                     Option (*const next)(OptionIterator *),
+                                                     OptionIterator *const source) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(NULL == source);
+    *self = (OptionIterator) {.__next=next, .__source=source};
+    return self;
+}
+
+/**
+ * Initializes self to yield the values returned by generate(context) until it returns `None`.
+ *
+ * @attention self must not be `NULL`.
+ * @attention generate must not be `NULL`.
+ */
+__attribute__((__always_inline__, __returns_nonnull__))
+static inline OptionIterator *OptionIterator_new(OptionIterator *const self, Option (*const generate)(void *context),
+                                                 void *const context) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(NULL == generate);
+    *self = (OptionIterator) {.__next=__OptionIterator_nextGenerated, .__f.generate=generate, .__context=context};
+    return self;
+}
+
+/**
+ * Initializes self to yield a pointer to each of the length elements of size bytes starting at items.
+ *
+ * @attention self must not be `NULL`.
+ * @attention items must not be `NULL` unless length is 0.
+ * @attention size must not be 0.
+ */
+__attribute__((__always_inline__, __returns_nonnull__))
+static inline OptionIterator *OptionIterator_fromArray(OptionIterator *const self, const void *const items,
+                                                       const size_t length, const size_t size) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(NULL == items && 0 < length);
+    __Option_panicWhen(0 == size);
+    __Option_panicWhen(length > SIZE_MAX / size);
+    *self = (OptionIterator) {
+            .__next=__OptionIterator_nextElement,
+            .__cursor=(const char *) items,
+            .__end=(const char *) items + length * size,
+            .__size=size,
+    };
+    return self;
+}
+
+/**
+ * Returns the next value of this `OptionIterator`, `None` if exhausted.
+ *
+ * @attention self must not be `NULL`.
+ */
+__attribute__((__always_inline__, __warn_unused_result__))
+static inline Option OptionIterator_next(OptionIterator *const self) {
+    __Option_panicWhen(NULL == self);
+    return self->__next(self);
+}
+
+/**
+ * Initializes self to yield f applied to the values of source.
+ *
+ * @attention self must not be `NULL`.
+ * @attention source must not be `NULL`.
+ * @attention f must not be `NULL` and must not return `NULL`, use `OptionIterator_filterMap(...)` to drop values.
+ */
+__attribute__((__always_inline__, __returns_nonnull__))
+static inline OptionIterator *OptionIterator_map(OptionIterator *const self, OptionIterator *const source,
+                                                 const void *(*const f)(const void *)) {
+    __Option_panicWhen(NULL == f);
+    __OptionIterator_adapt(self, __OptionIterator_nextMapped, source)->__f.map = f;
+    return self;
+}
+
+/**
+ * Initializes self to yield the values of source satisfying predicate.
+ *
+ * @attention self must not be `NULL`.
+ * @attention source must not be `NULL`.
+ * @attention predicate must not be `NULL`.
+ */
+__attribute__((__always_inline__, __returns_nonnull__))
+static inline OptionIterator *OptionIterator_filter(OptionIterator *const self, OptionIterator *const source,
+                                                    bool (*const predicate)(const void *)) {
+    __Option_panicWhen(NULL == predicate);
+    __OptionIterator_adapt(self, __OptionIterator_nextFiltered, source)->__f.filter = predicate;
+    return self;
+}
+
+/**
+ * Initializes self to yield the values wrapped by f applied to the values of source,
+ * like `Option_chain(...)` values for which f returns `None` are dropped.
+ *
+ * @attention self must not be `NULL`.
+ * @attention source must not be `NULL`.
+ * @attention f must not be `NULL`.
+ */
+__attribute__((__always_inline__, __returns_nonnull__))
+static inline OptionIterator *OptionIterator_filterMap(OptionIterator *const self, OptionIterator *const source,
+                                                       Option (*const f)(const void *)) {
+    __Option_panicWhen(NULL == f);
+    __OptionIterator_adapt(self, __OptionIterator_nextFilterMapped, source)->__f.filterMap = f;
+    return self;
+}
+
+/**
+ * Initializes self to yield at most the first count values of source.
+ *
+ * @attention self must not be `NULL`.
+ * @attention source must not be `NULL`.
+ */
+__attribute__((__always_inline__, __returns_nonnull__))
+static inline OptionIterator *OptionIterator_take(OptionIterator *const self, OptionIterator *const source,
+                                                  const size_t count) {
+    __OptionIterator_adapt(self, __OptionIterator_nextTaken, source)->__count = count;
+    return self;
+}
+
+/**
+ * Initializes self to yield the values of source after the first count ones.
+ *
+ * @attention self must not be `NULL`.
+ * @attention source must not be `NULL`.
+ */
+__attribute__((__always_inline__, __returns_nonnull__))
+static inline OptionIterator *OptionIterator_skip(OptionIterator *const self, OptionIterator *const source,
+                                                  const size_t count) {
+    __OptionIterator_adapt(self, __OptionIterator_nextSkipped, source)->__count = count;
+    return self;
+}
+
+/**
+ * Initializes self to yield f applied to pairs of values of first and second, until one of them is exhausted.
+ *
+ * @attention self must not be `NULL`.
+ * @attention first and second must not be `NULL`.
+ * @attention f must not be `NULL` and must not return `NULL`.
+ */
+__attribute__((__always_inline__, __returns_nonnull__))
+static inline OptionIterator *OptionIterator_zip(OptionIterator *const self, OptionIterator *const first,
+                                                 OptionIterator *const second,
+                                                 const void *(*const f)(const void *first, const void *second)) {
+    __Option_panicWhen(NULL == second);
+    __Option_panicWhen(NULL == f);
+    __OptionIterator_adapt(self, __OptionIterator_nextZipped, first)->__other = second;
+    self->__f.zip = f;
+    return self;
+}
+
+/**
+ * Consumes this `OptionIterator` returning f(...f(f(initial, v0), v1)..., vn).
+ *
+ * @attention self must not be `NULL`.
+ * @attention f must not be `NULL`.
+ */
+__attribute__((__always_inline__))
+static inline const void *OptionIterator_fold(OptionIterator *const self, const void *accumulator,
+                                              const void *(*const f)(const void *accumulator, const void *value)) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(NULL == f);
+    for (Option value = self->__next(self); (NULL != value.__value); value = self->__next(self)) {
+        accumulator = f(accumulator, value.__value);
+    }
+    return accumulator;
+}
+
+/**
+ * Consumes this `OptionIterator` returning the number of values it yielded.
+ *
+ * @attention self must not be `NULL`.
+ */
+__attribute__((__always_inline__))
+static inline size_t OptionIterator_count(OptionIterator *const self) {
+    __Option_panicWhen(NULL == self);
+    size_t count = 0;
+    for (Option value = self->__next(self); (NULL != value.__value); value = self->__next(self)) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * Fused pipelines: a source macro followed by stage macros, each governing the next statement, compose at compile time
+ * into a single loop calling the callbacks directly, with no iterator, adaptor or indirect call in between.
+ *
+ *      size_t remaining = 3;
+ *      OptionIterator_forArray(value, items, length, sizeof(items[0]))
+ *          OptionIterator_forFilter(value, isEven)
+ *              OptionIterator_forMap(value, square)
+ *                  OptionIterator_forTake(remaining) {
+ *                      total += *(const int *) value;
+ *                  }
+ *
+ * value names the current value, it is declared by the source and updated in place by the map stages.
+ * `continue` skips to the next value of the source, `break` ends the pipeline.
+ * Zipping needs two sources and is only available on runtime chains.
+ */
+
+/**
+ * Source of a fused pipeline yielding a pointer to each of the length elements of size bytes starting at items.
+ *
+ * @attention items must not be `NULL` unless length is 0.
+ * @attention size is evaluated at every step.
+ */
+#define OptionIterator_forArray(value, items, length, size)                                                            \
+    for (const char *__optionCursor = (const char *) (items),                                                          \
+             *const __optionEnd = __optionCursor + (length) * (size),                                                  \
+             *value = __optionCursor, *__optionStop = NULL;                                                            \
+         __optionCursor < __optionEnd && NULL == __optionStop;                                                         \
+         value = (__optionCursor += (size)))
+
+/**
+ * Source of a fused pipeline yielding the values of a runtime `OptionIterator`.
+ *
+ * @attention iterator must not be `NULL` and is evaluated at every step.
+ * The iterator is not advanced past the value that ends the pipeline.
+ */
+#define OptionIterator_forEach(value, iterator)                                                                        \
+    for (const void *value = OptionIterator_next(iterator).__value, *__optionStop = NULL;                              \
+         NULL != value && NULL == __optionStop;                                                                        \
+         value = NULL == __optionStop ? OptionIterator_next(iterator).__value : NULL)
+
+/**
+ * Stage of a fused pipeline keeping the values satisfying predicate.
+ */
+#define OptionIterator_forFilter(value, predicate) \
+    if ((predicate)(value))
+
+/**
+ * Stage of a fused pipeline replacing value with f applied to it.
+ *
+ * @attention f must not return `NULL`, use `OptionIterator_forFilterMap(...)` to drop values.
+ */
+#define OptionIterator_forMap(value, f) \
+    if ((value) = (f)(value), true)
+
+/**
+ * Stage of a fused pipeline replacing value with the value wrapped by f applied to it, dropping it if `None`.
+ */
+#define OptionIterator_forFilterMap(value, f) \
+    if (NULL != ((value) = (f)(value).__value))
+
+/**
+ * Stage of a fused pipeline letting through at most remaining values, then ending the pipeline.
+ * remaining is decremented as values go through.
+ *
+ * @attention remaining must be a `size_t` lvalue.
+ */
+#define OptionIterator_forTake(remaining) \
+    if (0 == (remaining) ? (__optionStop = "", false) : (0 < --(remaining) || (__optionStop = "", true)))
+
+/**
+ * Stage of a fused pipeline dropping the first remaining values.
+ * remaining is decremented as values are dropped.
+ *
+ * @attention remaining must be a `size_t` lvalue.
+ */
+#define OptionIterator_forSkip(remaining) \
+    if (0 == (remaining) || ((remaining)--, false))
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,228 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <time.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <panic/panic.h>
+#include "option-contract.h"
+#include "option-memo.h"
+
+#define NIL     SIZE_MAX
+
+typedef struct Entry {
+    const void *key;
+    Option value;
+    size_t hash;
+    size_t next;            // next entry of the same bucket
+    uint64_t expiry;        // 0 if the entry never expires
+    bool referenced;        // CLOCK bit, set on hits and cleared as the hand passes
+} Entry;
+
+struct OptionMemo {
+    Option (*f)(const void *);
+    size_t (*hash)(const void *);
+    bool (*equal)(const void *, const void *);
+    uint64_t ttl;
+    pthread_mutex_t mutex;
+    size_t capacity;
+    size_t size;
+    size_t hand;
+    size_t mask;            // buckets - 1, buckets is a power of 2 not lower than capacity
+    size_t *buckets;
+    Entry *entries;
+    OptionMemoStats stats;
+};
+
+static uint64_t now(void);
+
+static size_t hashOf(const OptionMemo *self, const void *key);
+
+static size_t find(const OptionMemo *self, const void *key, size_t hash);
+
+static void detach(OptionMemo *self, size_t index);
+
+static size_t claim(OptionMemo *self);
+
+OptionMemo *OptionMemo_new(Option (*const f)(const void *), const size_t capacity,
+                           size_t (*const hash)(const void *), bool (*const equal)(const void *, const void *),
+                           const uint64_t ttl) {
+    __Option_panicWhen(NULL == f);
+    __Option_panicWhen(0 == capacity);
+    __Option_panicWhen((NULL == hash) != (NULL == equal));
+    // the buckets are the next power of 2, less than twice capacity
+    Panic_when(capacity > SIZE_MAX / 2 / sizeof(size_t));
+    OptionMemo *self = calloc(1, sizeof(*self));
+    Panic_when(NULL == self);
+    size_t buckets = 1;
+    while (buckets < capacity) {
+        buckets *= 2;
+    }
+    self->buckets = malloc(buckets * sizeof(self->buckets[0]));
+    self->entries = calloc(capacity, sizeof(self->entries[0]));
+    Panic_when(NULL == self->buckets || NULL == self->entries);
+    for (size_t i = 0; i < buckets; i++) {
+        self->buckets[i] = NIL;
+    }
+    self->f = f;
+    self->hash = hash;
+    self->equal = equal;
+    self->ttl = ttl;
+    self->capacity = capacity;
+    self->mask = buckets - 1;
+    Panic_unless(0 == pthread_mutex_init(&self->mutex, NULL));
+    return self;
+}
+
+void OptionMemo_delete(OptionMemo *const self) {
+    if (NULL != self) {
+        pthread_mutex_destroy(&self->mutex);
+        free(self->entries);
+        free(self->buckets);
+        free(self);
+    }
+}
+
+Option OptionMemo_call(void *const memo, const void *const key) {
+    __Option_panicWhen(NULL == memo);
+    OptionMemo *const self = memo;
+    const size_t hash = hashOf(self, key);
+    const uint64_t timestamp = self->ttl ? now() : 0;
+
+    Panic_unless(0 == pthread_mutex_lock(&self->mutex));
+    size_t index = find(self, key, hash);
+    if (NIL != index) {
+        Entry *const entry = &self->entries[index];
+        if (0 == entry->expiry || timestamp < entry->expiry) {
+            entry->referenced = true;
+            self->stats.hits++;
+            const Option value = entry->value;
+            Panic_unless(0 == pthread_mutex_unlock(&self->mutex));
+            return value;
+        }
+    }
+    self->stats.misses++;
+    Panic_unless(0 == pthread_mutex_unlock(&self->mutex));
+
+    const Option value = self->f(key);
+
+    Panic_unless(0 == pthread_mutex_lock(&self->mutex));
+    // the entry may have been evicted, refreshed or inserted by another thread meanwhile
+    index = find(self, key, hash);
+    if (NIL == index) {
+        index = claim(self);
+        Entry *const entry = &self->entries[index];
+        entry->key = key;
+        entry->hash = hash;
+        entry->next = self->buckets[hash & self->mask];
+        entry->referenced = false;
+        self->buckets[hash & self->mask] = index;
+    }
+    // a refreshed entry keeps its CLOCK bit: it was used, only its value went stale
+    Entry *const entry = &self->entries[index];
+    entry->value = value;
+    entry->expiry = self->ttl ? timestamp + self->ttl : 0;
+    Panic_unless(0 == pthread_mutex_unlock(&self->mutex));
+    return value;
+}
+
+void OptionMemo_clear(OptionMemo *const self) {
+    __Option_panicWhen(NULL == self);
+    Panic_unless(0 == pthread_mutex_lock(&self->mutex));
+    for (size_t i = 0; i <= self->mask; i++) {
+        self->buckets[i] = NIL;
+    }
+    self->size = 0;
+    self->hand = 0;
+    Panic_unless(0 == pthread_mutex_unlock(&self->mutex));
+}
+
+OptionMemoStats OptionMemo_stats(OptionMemo *const self) {
+    __Option_panicWhen(NULL == self);
+    Panic_unless(0 == pthread_mutex_lock(&self->mutex));
+    OptionMemoStats stats = self->stats;
+    stats.size = self->size;
+    Panic_unless(0 == pthread_mutex_unlock(&self->mutex));
+    return stats;
+}
+
+/*
+ *
+ */
+uint64_t now(void) {
+    struct timespec timestamp;
+    clock_gettime(CLOCK_MONOTONIC, &timestamp);
+    return (uint64_t) timestamp.tv_sec * 1000000000u + (uint64_t) timestamp.tv_nsec;
+}
+
+size_t hashOf(const OptionMemo *const self, const void *const key) {
+    if (NULL != self->hash) {
+        return self->hash(key);
+    }
+    // Fibonacci hashing of the address, the low bits of pointers are mostly zeros
+    const uint64_t address = (uintptr_t) key;
+    return (size_t) ((address * UINT64_C(11400714819323198485)) >> 17);
+}
+
+size_t find(const OptionMemo *const self, const void *const key, const size_t hash) {
+    for (size_t index = self->buckets[hash & self->mask]; NIL != index; index = self->entries[index].next) {
+        const Entry *const entry = &self->entries[index];
+        if (entry->hash == hash && (entry->key == key || (NULL != self->equal && self->equal(entry->key, key)))) {
+            return index;
+        }
+    }
+    return NIL;
+}
+
+void detach(OptionMemo *const self, const size_t index) {
+    size_t *link = &self->buckets[self->entries[index].hash & self->mask];
+    while (*link != index) {
+        link = &self->entries[*link].next;
+    }
+    *link = self->entries[index].next;
+}
+
+/*
+ * Returns the index of an unused entry, evicting one if the table is full.
+ */
+size_t claim(OptionMemo *const self) {
+    if (self->size < self->capacity) {
+        return self->size++;
+    }
+    for (;; self->hand = (self->hand + 1) % self->capacity) {
+        Entry *const entry = &self->entries[self->hand];
+        if (entry->referenced) {
+            entry->referenced = false;
+            continue;
+        }
+        const size_t index = self->hand;
+        self->hand = (self->hand + 1) % self->capacity;
+        detach(self, index);
+        self->stats.evictions++;
+        return index;
+    }
+}
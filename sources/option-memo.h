@@ -0,0 +1,111 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "option.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A bounded memoization cache wrapping an `Option_chain(...)` callback: results, including `None`, are cached by key
+ * in a table of fixed capacity, which evicts entries with the CLOCK (second chance) policy once full.
+ * Entries can optionally expire after a time-to-live.
+ *
+ * `OptionMemo_call(...)` has the signature of `Option_chainWith(...)` callbacks, so wrapping a callback only changes
+ * the call site from `Option_chain(option, f)` to `Option_chainWith(option, OptionMemo_call, memo)`.
+ *
+ * The table is guarded by a mutex, the wrapped callback is called outside of it: concurrent misses on the same key
+ * may call it more than once.
+ */
+typedef struct OptionMemo OptionMemo;
+
+/**
+ * Counters of an `OptionMemo`.
+ */
+typedef struct OptionMemoStats {
+    size_t hits;
+    size_t misses;          // includes lookups of expired entries
+    size_t evictions;       // entries evicted to make room for new ones
+    size_t size;
+} OptionMemoStats;
+
+/**
+ * Creates a new `OptionMemo` caching at most capacity results of f.
+ * Keys are compared with hash and equal, or by address if both are `NULL`.
+ * Entries expire ttl nanoseconds after being cached, or never if ttl is 0.
+ * Panics if the cache would not fit the address space or if memory cannot be allocated.
+ *
+ * @attention f must not be `NULL`.
+ * @attention capacity must not be 0.
+ * @attention hash and equal must be both `NULL` or both not `NULL`, keys equal for equal must have the same hash.
+ * @attention keys must outlive the entries caching them, f must be pure.
+ */
+extern OptionMemo *OptionMemo_new(Option f(const void *key), size_t capacity, size_t hash(const void *key),
+                                  bool equal(const void *first, const void *second), uint64_t ttl)
+__attribute__((__warn_unused_result__, __returns_nonnull__));
+
+/**
+ * Deletes this `OptionMemo`.
+ */
+extern void OptionMemo_delete(OptionMemo *self);
+
+/**
+ * Returns the cached result of f(key), calling f and caching its result on a miss.
+ *
+ * @attention self must not be `NULL` and must point to an `OptionMemo`.
+ */
+extern Option OptionMemo_call(void *self, const void *key)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Removes every entry from this `OptionMemo`, counters are not reset.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern void OptionMemo_clear(OptionMemo *self);
+
+/**
+ * Returns the counters of this `OptionMemo`.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern OptionMemoStats OptionMemo_stats(OptionMemo *self)
+__attribute__((__warn_unused_result__));
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,104 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <panic/panic.h>
+#include "option-contract.h"
+#include "option-once.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#else
+#include <sched.h>
+#endif
+
+#define UNINITIALIZED   0u
+#define RUNNING         1u
+#define WAITING         2u      // running, with at least one blocked waiter
+#define INITIALIZED     3u
+
+static void waitWhile(uint32_t *state, uint32_t expected);
+
+static void wakeAll(uint32_t *state);
+
+Option __OptionOnce_initialize(OptionOnce *const self, Option (*const f)(void), Option (*const fWith)(void *),
+                               void *const context) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(NULL == f && NULL == fWith);
+    for (;;) {
+        uint32_t state = __atomic_load_n(&self->__state, __ATOMIC_ACQUIRE);
+        if (INITIALIZED == state) {
+            return (Option) {.__value=__atomic_load_n(&self->__value, __ATOMIC_ACQUIRE)};
+        }
+        if (UNINITIALIZED == state) {
+            if (!__atomic_compare_exchange_n(&self->__state, &state, RUNNING, false,
+                                             __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                continue;
+            }
+            const Option value = NULL != f ? f() : fWith(context);
+            if (Option_isSome(value)) {
+                __atomic_store_n(&self->__value, value.__value, __ATOMIC_RELEASE);
+            }
+            // on None the cell goes back to uninitialized, and one of the waiters retries
+            if (WAITING == __atomic_exchange_n(&self->__state, Option_isSome(value) ? INITIALIZED : UNINITIALIZED,
+                                               __ATOMIC_RELEASE)) {
+                wakeAll(&self->__state);
+            }
+            return value;
+        }
+        if (RUNNING == state && !__atomic_compare_exchange_n(&self->__state, &state, WAITING, false,
+                                                             __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            continue;
+        }
+        waitWhile(&self->__state, WAITING);
+    }
+}
+
+/*
+ *
+ */
+void waitWhile(uint32_t *const state, const uint32_t expected) {
+#if defined(__linux__)
+    const int error = errno;
+    syscall(SYS_futex, state, FUTEX_WAIT | FUTEX_PRIVATE_FLAG, expected, NULL, NULL, 0);
+    errno = error;
+#else
+    while (expected == __atomic_load_n(state, __ATOMIC_ACQUIRE)) {
+        sched_yield();
+    }
+#endif
+}
+
+void wakeAll(uint32_t *const state) {
+#if defined(__linux__)
+    syscall(SYS_futex, state, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, INT32_MAX, NULL, NULL, 0);
+#else
+    (void) state;
+#endif
+}
@@ -0,0 +1,115 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "option.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A lazily initialized `Option`, the thread-safe counterpart of caching the result of `Option_orElse(...)`.
+ *
+ * The first `OptionOnce_get(...)` runs the initializer, concurrent callers block until it completes and every later
+ * call returns the cached value with a single acquire load. An initializer returning `None` caches nothing: the next
+ * call runs an initializer again.
+ *
+ *      static OptionOnce config = OPTION_ONCE_INIT;
+ *      const Option value = OptionOnce_get(&config, loadConfig);
+ *
+ * @attention this struct must be treated as opaque therefore its members must not be accessed directly.
+ */
+typedef struct OptionOnce {
+    const void *__value;
+    uint32_t __state;
+} OptionOnce;
+
+/**
+ * Static initializer of an uninitialized `OptionOnce`.
+ */
+#define OPTION_ONCE_INIT \
+    {.__value=NULL, .__state=0}
+
+/**
+ * Slow path of `OptionOnce_get(...)` and `OptionOnce_getWith(...)`.
+ *
+ * @attention this function must be treated as opaque therefore must not be called directly.
+ */
+extern Option __OptionOnce_initialize(OptionOnce *self, Option f(void), Option fWith(void *context), void *context)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Returns the value of this `OptionOnce`, running f to initialize it if it has not been initialized yet.
+ * Returns `None` if f returns `None`, in that case this `OptionOnce` stays uninitialized.
+ *
+ * @attention self must not be `NULL`.
+ * @attention f must not be `NULL` and must not access this `OptionOnce`.
+ */
+__attribute__((__always_inline__, __warn_unused_result__))
+static inline Option OptionOnce_get(OptionOnce *const self, Option (*const f)(void)) {
+    const void *const value = __atomic_load_n(&self->__value, __ATOMIC_ACQUIRE);
+    if (__builtin_expect(NULL != value, 1)) {
+        return (Option) {.__value=value};
+    }
+    return __OptionOnce_initialize(self, f, NULL, NULL);
+}
+
+/**
+ * Like `OptionOnce_get(...)` but context is forwarded to f, allowing to carry state without globals.
+ *
+ * @attention self must not be `NULL`.
+ * @attention f must not be `NULL` and must not access this `OptionOnce`.
+ */
+__attribute__((__always_inline__, __warn_unused_result__))
+static inline Option OptionOnce_getWith(OptionOnce *const self, Option (*const f)(void *context), void *const context) {
+    const void *const value = __atomic_load_n(&self->__value, __ATOMIC_ACQUIRE);
+    if (__builtin_expect(NULL != value, 1)) {
+        return (Option) {.__value=value};
+    }
+    return __OptionOnce_initialize(self, NULL, f, context);
+}
+
+/**
+ * Returns the value of this `OptionOnce` if it has been initialized else `None`, without initializing it.
+ *
+ * @attention self must not be `NULL`.
+ */
+__attribute__((__always_inline__, __warn_unused_result__))
+static inline Option OptionOnce_peek(const OptionOnce *const self) {
+    return (Option) {.__value=__atomic_load_n(&self->__value, __ATOMIC_ACQUIRE)};
+}
+
+#ifdef __cplusplus
+}
+#endif
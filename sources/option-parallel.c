@@ -0,0 +1,227 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <panic/panic.h>
+#include "option-contract.h"
+#include "option-parallel.h"
+
+#define CACHE_LINE      64
+#define MIN_CHUNK       1024    // items claimed at once, at least
+#define CHUNKS          8       // chunks per worker range, at least
+
+typedef struct {
+    size_t cursor;              // next unclaimed item, advanced with an atomic increment
+    size_t end;
+} __attribute__((__aligned__(CACHE_LINE))) Range;
+
+typedef struct {
+    Option *items;
+    size_t chunk;
+    const void *(*map)(const void *);
+    Option (*chain)(const void *);
+} Job;
+
+typedef struct {
+    OptionPool *pool;
+    size_t index;
+} Worker;
+
+struct OptionPool {
+    size_t workers;
+    pthread_t *threads;
+    Worker *arguments;
+    Range *ranges;
+    Job job;
+    pthread_mutex_t mutex;
+    pthread_cond_t started;
+    pthread_cond_t finished;
+    size_t generation;          // incremented for every job, guarded by mutex
+    size_t running;             // threads still working on the current job, guarded by mutex
+    bool stopping;
+};
+
+static void *workerMain(void *argument);
+
+static void run(OptionPool *self, Option *items, size_t length,
+                const void *map(const void *), Option chain(const void *));
+
+static void work(OptionPool *self, size_t index);
+
+OptionPool *OptionPool_new(size_t workers) {
+    if (0 == workers) {
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = online > 0 ? (size_t) online : 1;
+    }
+    OptionPool *self = calloc(1, sizeof(*self));
+    Panic_when(NULL == self);
+    self->workers = workers;
+    self->threads = calloc(workers, sizeof(self->threads[0]));
+    self->arguments = calloc(workers, sizeof(self->arguments[0]));
+    Panic_when(NULL == self->threads || NULL == self->arguments);
+    Panic_unless(0 == posix_memalign((void **) &self->ranges, CACHE_LINE, workers * sizeof(self->ranges[0])));
+    Panic_unless(0 == pthread_mutex_init(&self->mutex, NULL));
+    Panic_unless(0 == pthread_cond_init(&self->started, NULL));
+    Panic_unless(0 == pthread_cond_init(&self->finished, NULL));
+    // worker 0 is the calling thread
+    for (size_t i = 1; i < workers; i++) {
+        self->arguments[i] = (Worker) {.pool=self, .index=i};
+        Panic_unless(0 == pthread_create(self->threads + i, NULL, workerMain, self->arguments + i));
+    }
+    return self;
+}
+
+void OptionPool_delete(OptionPool *const self) {
+    if (NULL != self) {
+        Panic_unless(0 == pthread_mutex_lock(&self->mutex));
+        self->stopping = true;
+        Panic_unless(0 == pthread_cond_broadcast(&self->started));
+        Panic_unless(0 == pthread_mutex_unlock(&self->mutex));
+        for (size_t i = 1; i < self->workers; i++) {
+            Panic_unless(0 == pthread_join(self->threads[i], NULL));
+        }
+        pthread_cond_destroy(&self->finished);
+        pthread_cond_destroy(&self->started);
+        pthread_mutex_destroy(&self->mutex);
+        free(self->ranges);
+        free(self->arguments);
+        free(self->threads);
+        free(self);
+    }
+}
+
+size_t OptionPool_workers(const OptionPool *const self) {
+    __Option_panicWhen(NULL == self);
+    return self->workers;
+}
+
+void Option_parallelMap(OptionPool *const pool, Option *const items, const size_t length,
+                        const void *(*const f)(const void *)) {
+    __Option_panicWhen(NULL == f);
+    run(pool, items, length, f, NULL);
+}
+
+void Option_parallelChain(OptionPool *const pool, Option *const items, const size_t length,
+                          Option (*const f)(const void *)) {
+    __Option_panicWhen(NULL == f);
+    run(pool, items, length, NULL, f);
+}
+
+/*
+ *
+ */
+void run(OptionPool *const self, Option *const items, const size_t length,
+         const void *(*const map)(const void *), Option (*const chain)(const void *)) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(NULL == items && 0 < length);
+    const size_t share = (length + self->workers - 1) / self->workers;
+    const size_t chunk = share / CHUNKS > MIN_CHUNK ? share / CHUNKS : MIN_CHUNK;
+    for (size_t i = 0; i < self->workers; i++) {
+        const size_t start = i * share < length ? i * share : length;
+        self->ranges[i] = (Range) {.cursor=start, .end=start + share < length ? start + share : length};
+    }
+    self->job = (Job) {.items=items, .chunk=chunk, .map=map, .chain=chain};
+
+    // too little work to be worth waking the other workers up
+    const bool alone = 1 == self->workers || length <= chunk;
+    if (!alone) {
+        Panic_unless(0 == pthread_mutex_lock(&self->mutex));
+        self->running = self->workers - 1;
+        self->generation++;
+        Panic_unless(0 == pthread_cond_broadcast(&self->started));
+        Panic_unless(0 == pthread_mutex_unlock(&self->mutex));
+    }
+
+    work(self, 0);
+
+    if (!alone) {
+        Panic_unless(0 == pthread_mutex_lock(&self->mutex));
+        while (0 < self->running) {
+            Panic_unless(0 == pthread_cond_wait(&self->finished, &self->mutex));
+        }
+        Panic_unless(0 == pthread_mutex_unlock(&self->mutex));
+    }
+}
+
+void *workerMain(void *const argument) {
+    const Worker *const worker = argument;
+    OptionPool *const self = worker->pool;
+    size_t generation = 0;
+
+    Panic_unless(0 == pthread_mutex_lock(&self->mutex));
+    for (;;) {
+        while (!self->stopping && generation == self->generation) {
+            Panic_unless(0 == pthread_cond_wait(&self->started, &self->mutex));
+        }
+        if (self->stopping) {
+            break;
+        }
+        generation = self->generation;
+        Panic_unless(0 == pthread_mutex_unlock(&self->mutex));
+
+        work(self, worker->index);
+
+        Panic_unless(0 == pthread_mutex_lock(&self->mutex));
+        if (0 == --self->running) {
+            Panic_unless(0 == pthread_cond_signal(&self->finished));
+        }
+    }
+    Panic_unless(0 == pthread_mutex_unlock(&self->mutex));
+    return NULL;
+}
+
+void work(OptionPool *const self, const size_t index) {
+    const Job job = self->job;
+    // own range first, then steal from the following ones
+    for (size_t i = 0; i < self->workers; i++) {
+        Range *const range = self->ranges + (index + i) % self->workers;
+        for (;;) {
+            const size_t start = __atomic_fetch_add(&range->cursor, job.chunk, __ATOMIC_RELAXED);
+            if (start >= range->end) {
+                break;
+            }
+            const size_t end = start + job.chunk < range->end ? start + job.chunk : range->end;
+            Option *const items = job.items;
+            if (NULL != job.map) {
+                for (size_t k = start; k < end; k++) {
+                    if (Option_isSome(items[k])) {
+                        items[k] = Option_fromNullable(job.map(items[k].__value));
+                    }
+                }
+            } else {
+                for (size_t k = start; k < end; k++) {
+                    if (Option_isSome(items[k])) {
+                        items[k] = job.chain(items[k].__value);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "option.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A pool of worker threads running `Option_parallelMap(...)` and `Option_parallelChain(...)`.
+ *
+ * The items are split in one range per worker, each worker claims chunks of its range with an atomic increment and,
+ * once its range is exhausted, steals chunks from the ranges of the other workers the same way.
+ * Every item is written by exactly one worker and depends only on its previous value, so results are deterministic.
+ * The calling thread works as well: a pool of n workers runs n - 1 threads.
+ */
+typedef struct OptionPool OptionPool;
+
+/**
+ * Creates a new `OptionPool` of workers workers, 0 means one per online processor.
+ * Panics if memory or threads cannot be allocated.
+ */
+extern OptionPool *OptionPool_new(size_t workers)
+__attribute__((__warn_unused_result__, __returns_nonnull__));
+
+/**
+ * Stops the workers and deletes this `OptionPool`.
+ */
+extern void OptionPool_delete(OptionPool *self);
+
+/**
+ * Returns the number of workers of this `OptionPool`, the calling thread included.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern size_t OptionPool_workers(const OptionPool *self)
+__attribute__((__warn_unused_result__));
+
+/**
+ * In-place `Option_map(...)` of every item, run by the workers of pool.
+ * Returns when every item has been processed.
+ *
+ * @attention pool must not be `NULL` and must not be running another operation.
+ * @attention items must not be `NULL` unless length is 0.
+ * @attention f must not be `NULL` and must be safe to call concurrently.
+ */
+extern void Option_parallelMap(OptionPool *pool, Option *items, size_t length, const void *f(const void *));
+
+/**
+ * In-place `Option_chain(...)` of every item, run by the workers of pool.
+ * Returns when every item has been processed.
+ *
+ * @attention pool must not be `NULL` and must not be running another operation.
+ * @attention items must not be `NULL` unless length is 0.
+ * @attention f must not be `NULL` and must be safe to call concurrently.
+ */
+extern void Option_parallelChain(OptionPool *pool, Option *items, size_t length, Option f(const void *));
+
+#ifdef __cplusplus
+}
+#endif
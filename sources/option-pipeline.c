@@ -0,0 +1,199 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <panic/panic.h>
+#include "option-contract.h"
+#include "option-pipeline.h"
+
+#define END     SIZE_MAX
+
+typedef enum {
+    STAGE_MAP,
+    STAGE_CHAIN,
+    STAGE_ALT,
+    STAGE_OR_ELSE,
+} StageKind;
+
+typedef struct {
+    StageKind kind;
+    size_t onNone;      // the first recovery (alt or orElse) stage after this one, END if none
+    uint64_t noneCount;
+    union {
+        const void *(*map)(const void *);
+        Option (*chain)(const void *);
+        Option (*orElse)(void);
+        Option alt;
+    } as;
+} Stage;
+
+struct OptionPipeline {
+    size_t length;
+    size_t capacity;
+    Stage *stages;
+};
+
+static OptionPipeline *append(OptionPipeline *self, Stage stage)
+__attribute__((__returns_nonnull__));
+
+static bool isRecovery(const Stage *stage);
+
+static size_t firstRecovery(const OptionPipeline *self);
+
+static Option execute(OptionPipeline *self, Option value);
+
+OptionPipeline *OptionPipeline_new(void) {
+    OptionPipeline *self = calloc(1, sizeof(*self));
+    Panic_when(NULL == self);
+    return self;
+}
+
+void OptionPipeline_delete(OptionPipeline *const self) {
+    if (NULL != self) {
+        free(self->stages);
+        free(self);
+    }
+}
+
+OptionPipeline *OptionPipeline_map(OptionPipeline *const self, const void *(*const f)(const void *)) {
+    __Option_panicWhen(NULL == f);
+    return append(self, (Stage) {.kind=STAGE_MAP, .as.map=f});
+}
+
+OptionPipeline *OptionPipeline_chain(OptionPipeline *const self, Option (*const f)(const void *)) {
+    __Option_panicWhen(NULL == f);
+    return append(self, (Stage) {.kind=STAGE_CHAIN, .as.chain=f});
+}
+
+OptionPipeline *OptionPipeline_alt(OptionPipeline *const self, const Option other) {
+    return append(self, (Stage) {.kind=STAGE_ALT, .as.alt=other});
+}
+
+OptionPipeline *OptionPipeline_orElse(OptionPipeline *const self, Option (*const f)(void)) {
+    __Option_panicWhen(NULL == f);
+    return append(self, (Stage) {.kind=STAGE_OR_ELSE, .as.orElse=f});
+}
+
+size_t OptionPipeline_length(const OptionPipeline *const self) {
+    __Option_panicWhen(NULL == self);
+    return self->length;
+}
+
+Option OptionPipeline_run(OptionPipeline *const self, const Option input) {
+    __Option_panicWhen(NULL == self);
+    return execute(self, input);
+}
+
+void OptionPipeline_runAll(OptionPipeline *const self, Option *const items, const size_t length) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(NULL == items && 0 < length);
+    for (size_t i = 0; i < length; i++) {
+        items[i] = execute(self, items[i]);
+    }
+}
+
+uint64_t OptionPipeline_noneCount(const OptionPipeline *const self, const size_t stage) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(stage >= self->length);
+    return __atomic_load_n(&self->stages[stage].noneCount, __ATOMIC_RELAXED);
+}
+
+void OptionPipeline_resetCounters(OptionPipeline *const self) {
+    __Option_panicWhen(NULL == self);
+    for (size_t i = 0; i < self->length; i++) {
+        __atomic_store_n(&self->stages[i].noneCount, 0, __ATOMIC_RELAXED);
+    }
+}
+
+/*
+ *
+ */
+OptionPipeline *append(OptionPipeline *const self, Stage stage) {
+    __Option_panicWhen(NULL == self);
+    if (self->length == self->capacity) {
+        const size_t capacity = 0 == self->capacity ? 4 : self->capacity * 2;
+        Stage *stages = realloc(self->stages, capacity * sizeof(stages[0]));
+        Panic_when(NULL == stages);
+        self->stages = stages;
+        self->capacity = capacity;
+    }
+
+    const size_t index = self->length++;
+    stage.onNone = END;
+    stage.noneCount = 0;
+    self->stages[index] = stage;
+
+    if (isRecovery(&stage)) {
+        // previous stages that were jumping to the end on None now recover here
+        for (size_t i = index; i > 0 && END == self->stages[i - 1].onNone; i--) {
+            self->stages[i - 1].onNone = index;
+        }
+    }
+    return self;
+}
+
+bool isRecovery(const Stage *const stage) {
+    return STAGE_ALT == stage->kind || STAGE_OR_ELSE == stage->kind;
+}
+
+size_t firstRecovery(const OptionPipeline *const self) {
+    if (0 == self->length) {
+        return END;
+    }
+    return isRecovery(self->stages) ? 0 : self->stages[0].onNone;
+}
+
+Option execute(OptionPipeline *const self, Option value) {
+    // map and chain stages are only ever visited with a value: None jumps straight to the next recovery stage
+    size_t i = Option_isSome(value) ? 0 : firstRecovery(self);
+
+    while (i < self->length) {
+        Stage *const stage = self->stages + i;
+        switch (stage->kind) {
+            case STAGE_MAP:
+                value = Option_fromNullable(stage->as.map(value.__value));
+                break;
+            case STAGE_CHAIN:
+                value = stage->as.chain(value.__value);
+                break;
+            case STAGE_ALT:
+                value = Option_isSome(value) ? value : stage->as.alt;
+                break;
+            case STAGE_OR_ELSE:
+                value = Option_isSome(value) ? value : stage->as.orElse();
+                break;
+        }
+        if (Option_isSome(value)) {
+            i++;
+        } else {
+            __atomic_fetch_add(&stage->noneCount, 1, __ATOMIC_RELAXED);
+            i = stage->onNone;
+        }
+    }
+    return value;
+}
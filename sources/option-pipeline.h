@@ -0,0 +1,141 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "option.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A sequence of combinators built and validated once, then executed over many inputs.
+ *
+ * Stages are stored in a flat array: a `None` produced by a `map` or `chain` stage jumps straight to the next
+ * `alt` or `orElse` stage (or to the end), without visiting the stages in between.
+ * Each stage counts how many times it produced `None`; counters are updated atomically,
+ * so a built pipeline can be run concurrently.
+ */
+typedef struct OptionPipeline OptionPipeline;
+
+/**
+ * Creates a new empty `OptionPipeline`, which behaves as the identity.
+ * Panics if memory cannot be allocated.
+ */
+extern OptionPipeline *OptionPipeline_new(void)
+__attribute__((__warn_unused_result__, __returns_nonnull__));
+
+/**
+ * Deletes this `OptionPipeline`.
+ */
+extern void OptionPipeline_delete(OptionPipeline *self);
+
+/**
+ * Appends an `Option_map(...)` stage, returns self.
+ *
+ * @attention self must not be `NULL`.
+ * @attention f must not be `NULL`.
+ */
+extern OptionPipeline *OptionPipeline_map(OptionPipeline *self, const void *f(const void *))
+__attribute__((__returns_nonnull__));
+
+/**
+ * Appends an `Option_chain(...)` stage, returns self.
+ *
+ * @attention self must not be `NULL`.
+ * @attention f must not be `NULL`.
+ */
+extern OptionPipeline *OptionPipeline_chain(OptionPipeline *self, Option f(const void *))
+__attribute__((__returns_nonnull__));
+
+/**
+ * Appends an `Option_alt(...)` stage, returns self.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern OptionPipeline *OptionPipeline_alt(OptionPipeline *self, Option other)
+__attribute__((__returns_nonnull__));
+
+/**
+ * Appends an `Option_orElse(...)` stage, returns self.
+ *
+ * @attention self must not be `NULL`.
+ * @attention f must not be `NULL`.
+ */
+extern OptionPipeline *OptionPipeline_orElse(OptionPipeline *self, Option f(void))
+__attribute__((__returns_nonnull__));
+
+/**
+ * Returns the number of stages of this `OptionPipeline`.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern size_t OptionPipeline_length(const OptionPipeline *self)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Runs this `OptionPipeline` over input.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern Option OptionPipeline_run(OptionPipeline *self, Option input)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Runs this `OptionPipeline` over every item, replacing it with the result.
+ *
+ * @attention self must not be `NULL`.
+ * @attention items must not be `NULL` unless length is 0.
+ */
+extern void OptionPipeline_runAll(OptionPipeline *self, Option *items, size_t length);
+
+/**
+ * Returns how many times stage produced `None`.
+ *
+ * @attention self must not be `NULL`.
+ * @attention stage must be less than the length of this `OptionPipeline`.
+ */
+extern uint64_t OptionPipeline_noneCount(const OptionPipeline *self, size_t stage)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Resets the `None` counters of every stage.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern void OptionPipeline_resetCounters(OptionPipeline *self);
+
+#ifdef __cplusplus
+}
+#endif
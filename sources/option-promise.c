@@ -0,0 +1,190 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <time.h>
+#include <errno.h>
+#include <panic/panic.h>
+#include "option-contract.h"
+#include "option-promise.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#define PENDING     0u
+#define FULFILLED   1u
+#define WAITING     2u      // pending, with at least one blocked waiter
+#define SPINS       128     // polls before blocking
+#define CLOSED      ((OptionPromiseContinuation *) 1)
+
+static bool block(OptionPromise *self, const struct timespec *deadline);
+
+static void wakeAll(OptionPromise *self);
+
+static void runContinuation(OptionPromiseContinuation *continuation, const void *value);
+
+void OptionPromise_init(OptionPromise *const self) {
+    __Option_panicWhen(NULL == self);
+    *self = (OptionPromise) OPTION_PROMISE_INIT;
+}
+
+void OptionPromise_fulfill(OptionPromise *const self, const void *const value) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(NULL == value);
+    const void *expected = NULL;
+    const bool first = __atomic_compare_exchange_n(&self->__value, &expected, value, false,
+                                                   __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+    __Option_panicWhen(!first);
+    if (WAITING == __atomic_exchange_n(&self->__state, FULFILLED, __ATOMIC_ACQ_REL)) {
+        wakeAll(self);
+    }
+
+    // continuations were pushed as a stack, run them in registration order
+    OptionPromiseContinuation *pending = __atomic_exchange_n(&self->__continuations, CLOSED, __ATOMIC_ACQ_REL);
+    OptionPromiseContinuation *ordered = NULL;
+    while (NULL != pending) {
+        OptionPromiseContinuation *const next = pending->__next;
+        pending->__next = ordered;
+        ordered = pending;
+        pending = next;
+    }
+    while (NULL != ordered) {
+        OptionPromiseContinuation *const next = ordered->__next;
+        runContinuation(ordered, value);
+        ordered = next;
+    }
+}
+
+Option OptionPromise_poll(const OptionPromise *const self) {
+    __Option_panicWhen(NULL == self);
+    return Option_fromNullable(__atomic_load_n(&self->__value, __ATOMIC_ACQUIRE));
+}
+
+Option OptionPromise_wait(OptionPromise *const self) {
+    __Option_panicWhen(NULL == self);
+    block(self, NULL);
+    return OptionPromise_poll(self);
+}
+
+Option OptionPromise_waitFor(OptionPromise *const self, const uint64_t timeout) {
+    __Option_panicWhen(NULL == self);
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += (time_t) (timeout / 1000000000u);
+    deadline.tv_nsec += (long) (timeout % 1000000000u);
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    block(self, &deadline);
+    return OptionPromise_poll(self);
+}
+
+void OptionPromise_then(OptionPromise *const self, OptionPromiseContinuation *const continuation,
+                        Option (*const f)(const void *)) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(NULL == continuation);
+    __Option_panicWhen(NULL == f);
+    *continuation = (OptionPromiseContinuation) {.__f=f, .__next=NULL, .__result=None, .__done=false};
+    OptionPromiseContinuation *head = __atomic_load_n(&self->__continuations, __ATOMIC_ACQUIRE);
+    do {
+        if (CLOSED == head) {
+            runContinuation(continuation, __atomic_load_n(&self->__value, __ATOMIC_ACQUIRE));
+            return;
+        }
+        continuation->__next = head;
+    } while (!__atomic_compare_exchange_n(&self->__continuations, &head, continuation, true,
+                                          __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+}
+
+bool OptionPromiseContinuation_isDone(const OptionPromiseContinuation *const continuation) {
+    __Option_panicWhen(NULL == continuation);
+    return __atomic_load_n(&continuation->__done, __ATOMIC_ACQUIRE);
+}
+
+Option OptionPromiseContinuation_result(const OptionPromiseContinuation *const continuation) {
+    __Option_panicWhen(NULL == continuation);
+    return OptionPromiseContinuation_isDone(continuation) ? continuation->__result : None;
+}
+
+/*
+ *
+ */
+bool block(OptionPromise *const self, const struct timespec *const deadline) {
+    for (size_t i = 0; i < SPINS; i++) {
+        if (FULFILLED == __atomic_load_n(&self->__state, __ATOMIC_ACQUIRE)) {
+            return true;
+        }
+    }
+
+    for (;;) {
+        // announce the waiter, so that the fulfilling thread knows it has to wake it up
+        uint32_t state = PENDING;
+        if (!__atomic_compare_exchange_n(&self->__state, &state, WAITING, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) &&
+            FULFILLED == state) {
+            return true;
+        }
+#if defined(__linux__)
+        // FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC deadline, NULL waits forever
+        const int error = errno;
+        const long result = syscall(SYS_futex, &self->__state, FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG, WAITING,
+                                    deadline, NULL, FUTEX_BITSET_MATCH_ANY);
+        const bool expired = result < 0 && ETIMEDOUT == errno;
+        errno = error;
+#else
+        const struct timespec pause = {.tv_sec=0, .tv_nsec=50000};
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        const bool expired = NULL != deadline && (now.tv_sec > deadline->tv_sec ||
+                                                  (now.tv_sec == deadline->tv_sec && now.tv_nsec >= deadline->tv_nsec));
+        if (!expired) {
+            nanosleep(&pause, NULL);
+        }
+#endif
+        if (FULFILLED == __atomic_load_n(&self->__state, __ATOMIC_ACQUIRE)) {
+            return true;
+        }
+        if (expired) {
+            return false;
+        }
+    }
+}
+
+void wakeAll(OptionPromise *const self) {
+#if defined(__linux__)
+    syscall(SYS_futex, &self->__state, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, INT32_MAX, NULL, NULL, 0);
+#else
+    (void) self;
+#endif
+}
+
+void runContinuation(OptionPromiseContinuation *const continuation, const void *const value) {
+    continuation->__result = continuation->__f(value);
+    __atomic_store_n(&continuation->__done, true, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,147 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "option.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A single-assignment cell: it starts as `None` and is fulfilled exactly once, by one writer, with a value.
+ * Readers poll it without synchronization costs beyond an acquire load or block until it is fulfilled
+ * (on a futex on Linux, no lock is ever taken). Continuations registered before the fulfilment run on the fulfilling
+ * thread, those registered after it run immediately on the registering thread.
+ *
+ * @attention this struct must be treated as opaque therefore its members must not be accessed directly.
+ */
+typedef struct OptionPromise OptionPromise;
+
+/**
+ * A continuation registered on an `OptionPromise`, provided by the caller and linked into the promise.
+ *
+ * @attention this struct must be treated as opaque therefore its members must not be accessed directly.
+ */
+typedef struct OptionPromiseContinuation OptionPromiseContinuation;
+
+struct OptionPromiseContinuation {
+    Option (*__f)(const void *value);
+    OptionPromiseContinuation *__next;
+    Option __result;
+    bool __done;
+};
+
+struct OptionPromise {
+    const void *__value;
+    uint32_t __state;
+    OptionPromiseContinuation *__continuations;
+};
+
+/**
+ * Static initializer of a pending `OptionPromise`.
+ */
+#define OPTION_PROMISE_INIT \
+    {.__value=NULL, .__state=0, .__continuations=NULL}
+
+/**
+ * Initializes self as a pending `OptionPromise`.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern void OptionPromise_init(OptionPromise *self);
+
+/**
+ * Fulfills this `OptionPromise` with value, wakes up the waiting threads and runs the registered continuations.
+ *
+ * @attention self must not be `NULL`.
+ * @attention value must not be `NULL`.
+ * @attention this `OptionPromise` must not have been fulfilled already.
+ */
+extern void OptionPromise_fulfill(OptionPromise *self, const void *value);
+
+/**
+ * Returns the value of this `OptionPromise` if it has been fulfilled else `None`, without blocking.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern Option OptionPromise_poll(const OptionPromise *self)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Blocks until this `OptionPromise` is fulfilled and returns its value.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern Option OptionPromise_wait(OptionPromise *self)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Blocks until this `OptionPromise` is fulfilled, or at most timeout nanoseconds.
+ * Returns its value, or `None` if the timeout expired.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern Option OptionPromise_waitFor(OptionPromise *self, uint64_t timeout)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Registers continuation to run f on the value of this `OptionPromise`, like `Option_chain(...)`.
+ * If this `OptionPromise` is already fulfilled f runs immediately, otherwise it runs on the fulfilling thread.
+ *
+ * @attention self must not be `NULL`.
+ * @attention continuation must not be `NULL` and must not be registered elsewhere until it is done.
+ * @attention f must not be `NULL`.
+ */
+extern void OptionPromise_then(OptionPromise *self, OptionPromiseContinuation *continuation, Option f(const void *));
+
+/**
+ * Returns `true` if continuation has run, `false` otherwise.
+ *
+ * @attention continuation must not be `NULL`.
+ */
+extern bool OptionPromiseContinuation_isDone(const OptionPromiseContinuation *continuation)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Returns the `Option` returned by the function of continuation, `None` if it has not run yet.
+ *
+ * @attention continuation must not be `NULL`.
+ */
+extern Option OptionPromiseContinuation_result(const OptionPromiseContinuation *continuation)
+__attribute__((__warn_unused_result__));
+
+#ifdef __cplusplus
+}
+#endif
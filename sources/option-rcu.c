@@ -0,0 +1,180 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <panic/panic.h>
+#include "option-contract.h"
+#include "option-rcu.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#endif
+
+#define CACHE_LINE      64
+
+/*
+ * Per-thread reader record: epoch is the grace-period epoch observed when the thread entered its outermost critical
+ * section, 0 outside of critical sections.
+ */
+typedef struct Reader {
+    uint64_t epoch;
+    struct Reader *next;        // every reader ever registered, never unlinked
+    bool active;
+} __attribute__((__aligned__(CACHE_LINE))) Reader;
+
+static Reader *globalReaders = NULL;
+static uint64_t globalEpoch = 1;
+static bool globalMembarrier = false;           // readers may skip their fence, writers issue membarrier instead
+static pthread_once_t globalOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t threadKey;
+static __thread Reader *threadReader = NULL;
+static __thread size_t threadNesting = 0;
+
+static Reader *registerReader(void)
+__attribute__((__noinline__, __returns_nonnull__));
+
+static void unregisterReader(void *reader);
+
+static void initialize(void);
+
+static void heavyBarrier(void);
+
+void OptionRcu_readLock(void) {
+    if (0 == threadNesting++) {
+        Reader *const reader = __builtin_expect(NULL != threadReader, 1) ? threadReader : registerReader();
+        __atomic_store_n(&reader->epoch, __atomic_load_n(&globalEpoch, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+        // orders the store above before the reads of the critical section, paired with heavyBarrier()
+        if (__atomic_load_n(&globalMembarrier, __ATOMIC_RELAXED)) {
+            __atomic_signal_fence(__ATOMIC_SEQ_CST);
+        } else {
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        }
+    }
+}
+
+void OptionRcu_readUnlock(void) {
+    __Option_panicWhen(0 == threadNesting);
+    if (0 == --threadNesting) {
+        __atomic_store_n(&threadReader->epoch, 0, __ATOMIC_RELEASE);
+    }
+}
+
+Option OptionRcu_read(const OptionRcu *const self) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(0 == threadNesting);
+    return (Option) {.__value=__atomic_load_n(&self->__value, __ATOMIC_ACQUIRE)};
+}
+
+void OptionRcu_publish(OptionRcu *const self, const Option option, void (*const reclaim)(void *)) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(NULL == reclaim);
+    const void *const old = __atomic_exchange_n(&self->__value, option.__value, __ATOMIC_SEQ_CST);
+    OptionRcu_synchronize();
+    if (NULL != old) {
+        reclaim((void *) old);
+    }
+}
+
+void OptionRcu_synchronize(void) {
+    __Option_panicWhen(0 != threadNesting);
+    Panic_unless(0 == pthread_once(&globalOnce, initialize));
+    // readers entering from now on observe at least this epoch, and every value published before
+    const uint64_t epoch = __atomic_add_fetch(&globalEpoch, 1, __ATOMIC_SEQ_CST);
+    heavyBarrier();
+    for (Reader *reader = __atomic_load_n(&globalReaders, __ATOMIC_ACQUIRE); NULL != reader; reader = reader->next) {
+        for (;;) {
+            const uint64_t observed = __atomic_load_n(&reader->epoch, __ATOMIC_ACQUIRE);
+            if (0 == observed || observed >= epoch) {
+                break;
+            }
+            sched_yield();
+        }
+    }
+    heavyBarrier();
+}
+
+/*
+ *
+ */
+Reader *registerReader(void) {
+    Panic_unless(0 == pthread_once(&globalOnce, initialize));
+    Reader *reader = NULL;
+    for (reader = __atomic_load_n(&globalReaders, __ATOMIC_ACQUIRE); NULL != reader; reader = reader->next) {
+        bool active = false;
+        if (!__atomic_load_n(&reader->active, __ATOMIC_RELAXED) &&
+            __atomic_compare_exchange_n(&reader->active, &active, true, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+    if (NULL == reader) {
+        Panic_unless(0 == posix_memalign((void **) &reader, CACHE_LINE, sizeof(*reader)));
+        reader->epoch = 0;
+        reader->active = true;
+        reader->next = __atomic_load_n(&globalReaders, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&globalReaders, &reader->next, reader, true,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    }
+    // the key is only used to recycle the record when the thread exits
+    Panic_unless(0 == pthread_setspecific(threadKey, reader));
+    threadReader = reader;
+    return reader;
+}
+
+void unregisterReader(void *const reader) {
+    __atomic_store_n(&((Reader *) reader)->epoch, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&((Reader *) reader)->active, false, __ATOMIC_RELEASE);
+    threadReader = NULL;
+}
+
+void initialize(void) {
+    Panic_unless(0 == pthread_key_create(&threadKey, unregisterReader));
+#if defined(__linux__) && defined(MEMBARRIER_CMD_PRIVATE_EXPEDITED)
+    if (0 == syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0)) {
+        __atomic_store_n(&globalMembarrier, true, __ATOMIC_RELEASE);
+    }
+#endif
+}
+
+/*
+ * Issues a full memory barrier on every running thread of the process if membarrier is available,
+ * a full barrier on the calling thread otherwise (then readers issue their own).
+ */
+void heavyBarrier(void) {
+#if defined(__linux__) && defined(MEMBARRIER_CMD_PRIVATE_EXPEDITED)
+    if (__atomic_load_n(&globalMembarrier, __ATOMIC_ACQUIRE)) {
+        Panic_unless(0 == syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0));
+        return;
+    }
+#endif
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
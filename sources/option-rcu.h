@@ -0,0 +1,107 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "option.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * An `Option` published with read-copy-update semantics, meant for read-mostly data such as configuration.
+ *
+ * Readers access the value inside a read-side critical section, delimited by `OptionRcu_readLock()` and
+ * `OptionRcu_readUnlock()`: entering and leaving it are plain stores to a per-thread record, without atomic
+ * read-modify-write instructions, and never wait for writers.
+ * Writers replace the value with `OptionRcu_publish(...)`, which waits for a grace period (until every critical
+ * section that might still see the old value has ended) before reclaiming it.
+ *
+ *      OptionRcu_readLock();
+ *      const Option config = OptionRcu_read(&published);
+ *      ...
+ *      OptionRcu_readUnlock();
+ *
+ * @attention this struct must be treated as opaque therefore its members must not be accessed directly.
+ */
+typedef struct OptionRcu {
+    const void *__value;
+} OptionRcu;
+
+/**
+ * Static initializer of an `OptionRcu` publishing `None`.
+ */
+#define OPTION_RCU_INIT \
+    {.__value=NULL}
+
+/**
+ * Enters a read-side critical section on the calling thread, critical sections can be nested.
+ * The first call on a thread registers it, which may allocate.
+ */
+extern void OptionRcu_readLock(void);
+
+/**
+ * Leaves the read-side critical section entered by the matching `OptionRcu_readLock()`.
+ *
+ * @attention the calling thread must be in a read-side critical section.
+ */
+extern void OptionRcu_readUnlock(void);
+
+/**
+ * Returns the value published in this `OptionRcu`, which remains valid until the read-side critical section ends.
+ *
+ * @attention self must not be `NULL`.
+ * @attention the calling thread must be in a read-side critical section.
+ */
+extern Option OptionRcu_read(const OptionRcu *self)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Publishes option in this `OptionRcu` then, after a grace period, calls reclaim on the value it replaced if any.
+ * Returns only once the replaced value is no longer visible to readers.
+ *
+ * @attention self must not be `NULL`.
+ * @attention reclaim must not be `NULL`.
+ * @attention the calling thread must not be in a read-side critical section.
+ */
+extern void OptionRcu_publish(OptionRcu *self, Option option, void reclaim(void *));
+
+/**
+ * Waits until every read-side critical section in progress on any thread has ended.
+ *
+ * @attention the calling thread must not be in a read-side critical section.
+ */
+extern void OptionRcu_synchronize(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,248 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <panic/panic.h>
+#include "option-contract.h"
+#include "option-slab.h"
+
+#define SIZE_CLASS      16      // object sizes are rounded to multiples of, and the header is as large as, SIZE_CLASS
+#define BLOCK_OBJECTS   64      // objects carved at once when a cache runs out
+#define BATCH_OBJECTS   32      // remote frees pushed at once
+
+typedef struct Object {
+    struct Object *next;
+} Object;
+
+/*
+ * Every object is preceded by a header naming the cache that carved it.
+ */
+typedef struct {
+    struct Cache *owner;
+} __attribute__((__aligned__(SIZE_CLASS))) Header;
+
+typedef struct Block {
+    struct Block *next;
+} __attribute__((__aligned__(SIZE_CLASS))) Block;
+
+typedef struct Cache {
+    OptionSlab *slab;
+    struct Cache *next;         // every cache of the slab, guarded by the slab mutex
+    struct Cache *nextOrphan;   // caches of exited threads, guarded by the slab mutex
+    Object *local;              // owner only
+    Object *remote;             // pushed by other threads, drained by the owner
+    struct Cache *batchOwner;   // owner only: objects of batchOwner freed by this thread
+    Object *batchHead;
+    Object *batchTail;
+    size_t batchCount;
+} Cache;
+
+struct OptionSlab {
+    size_t objectSize;
+    pthread_key_t key;
+    pthread_mutex_t mutex;
+    Cache *caches;
+    Cache *orphans;
+    Block *blocks;
+};
+
+static Cache *threadCache(OptionSlab *self)
+__attribute__((__returns_nonnull__));
+
+static Cache *attachCache(OptionSlab *self)
+__attribute__((__noinline__, __returns_nonnull__));
+
+static void detachCache(void *cache);
+
+static bool refill(Cache *cache)
+__attribute__((__noinline__));
+
+static void flushBatch(Cache *cache);
+
+static Header *headerOf(const void *object);
+
+OptionSlab *OptionSlab_new(const size_t size) {
+    OptionSlab *self = calloc(1, sizeof(*self));
+    Panic_when(NULL == self);
+    Panic_when(size > SIZE_MAX / 2);
+    const size_t objectSize = size < sizeof(Object) ? sizeof(Object) : size;
+    self->objectSize = (objectSize + SIZE_CLASS - 1) / SIZE_CLASS * SIZE_CLASS;
+    Panic_unless(0 == pthread_key_create(&self->key, detachCache));
+    Panic_unless(0 == pthread_mutex_init(&self->mutex, NULL));
+    return self;
+}
+
+void OptionSlab_delete(OptionSlab *const self) {
+    if (NULL != self) {
+        pthread_key_delete(self->key);
+        pthread_mutex_destroy(&self->mutex);
+        for (Cache *cache = self->caches, *next; NULL != cache; cache = next) {
+            next = cache->next;
+            free(cache);
+        }
+        for (Block *block = self->blocks, *next; NULL != block; block = next) {
+            next = block->next;
+            free(block);
+        }
+        free(self);
+    }
+}
+
+size_t OptionSlab_objectSize(const OptionSlab *const self) {
+    __Option_panicWhen(NULL == self);
+    return self->objectSize;
+}
+
+Option OptionSlab_alloc(OptionSlab *const self) {
+    __Option_panicWhen(NULL == self);
+    Cache *const cache = threadCache(self);
+    if (__builtin_expect(NULL == cache->local, 0) && !refill(cache)) {
+        return None;
+    }
+    Object *const object = cache->local;
+    cache->local = object->next;
+    return Option_some(object);
+}
+
+void OptionSlab_free(OptionSlab *const self, const void *const object) {
+    __Option_panicWhen(NULL == self);
+    if (NULL == object) {
+        return;
+    }
+    Cache *const cache = threadCache(self);
+    Cache *const owner = headerOf(object)->owner;
+    __Option_panicWhen(self != owner->slab);
+    Object *const node = (Object *) object;
+
+    if (owner == cache) {
+        node->next = cache->local;
+        cache->local = node;
+        return;
+    }
+    if (owner != cache->batchOwner) {
+        flushBatch(cache);
+        cache->batchOwner = owner;
+    }
+    node->next = cache->batchHead;
+    cache->batchHead = node;
+    cache->batchTail = NULL == cache->batchTail ? node : cache->batchTail;
+    if (++cache->batchCount == BATCH_OBJECTS) {
+        flushBatch(cache);
+    }
+}
+
+void OptionSlab_flush(OptionSlab *const self) {
+    __Option_panicWhen(NULL == self);
+    flushBatch(threadCache(self));
+}
+
+/*
+ *
+ */
+Cache *threadCache(OptionSlab *const self) {
+    Cache *const cache = pthread_getspecific(self->key);
+    return __builtin_expect(NULL != cache, 1) ? cache : attachCache(self);
+}
+
+Cache *attachCache(OptionSlab *const self) {
+    Panic_unless(0 == pthread_mutex_lock(&self->mutex));
+    Cache *cache = self->orphans;
+    if (NULL != cache) {
+        self->orphans = cache->nextOrphan;
+    } else {
+        cache = calloc(1, sizeof(*cache));
+        Panic_when(NULL == cache);
+        cache->slab = self;
+        cache->next = self->caches;
+        self->caches = cache;
+    }
+    Panic_unless(0 == pthread_mutex_unlock(&self->mutex));
+    Panic_unless(0 == pthread_setspecific(self->key, cache));
+    return cache;
+}
+
+void detachCache(void *const data) {
+    Cache *const cache = data;
+    OptionSlab *const self = cache->slab;
+    flushBatch(cache);
+    Panic_unless(0 == pthread_mutex_lock(&self->mutex));
+    cache->nextOrphan = self->orphans;
+    self->orphans = cache;
+    Panic_unless(0 == pthread_mutex_unlock(&self->mutex));
+}
+
+bool refill(Cache *const cache) {
+    // objects returned by other threads first
+    Object *remote = __atomic_exchange_n(&cache->remote, NULL, __ATOMIC_ACQUIRE);
+    if (NULL != remote) {
+        cache->local = remote;
+        return true;
+    }
+
+    OptionSlab *const self = cache->slab;
+    const size_t stride = sizeof(Header) + self->objectSize;
+    Block *const block = malloc(sizeof(*block) + BLOCK_OBJECTS * stride);
+    if (NULL == block) {
+        return false;
+    }
+    Panic_unless(0 == pthread_mutex_lock(&self->mutex));
+    block->next = self->blocks;
+    self->blocks = block;
+    Panic_unless(0 == pthread_mutex_unlock(&self->mutex));
+
+    char *cursor = (char *) (block + 1) + BLOCK_OBJECTS * stride;
+    for (size_t i = 0; i < BLOCK_OBJECTS; i++) {
+        cursor -= stride;
+        Header *const header = (Header *) cursor;
+        Object *const object = (Object *) (header + 1);
+        header->owner = cache;
+        object->next = cache->local;
+        cache->local = object;
+    }
+    return true;
+}
+
+void flushBatch(Cache *const cache) {
+    if (0 == cache->batchCount) {
+        return;
+    }
+    Cache *const owner = cache->batchOwner;
+    Object *head = __atomic_load_n(&owner->remote, __ATOMIC_RELAXED);
+    do {
+        cache->batchTail->next = head;
+    } while (!__atomic_compare_exchange_n(&owner->remote, &head, cache->batchHead, true,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    cache->batchHead = cache->batchTail = NULL;
+    cache->batchCount = 0;
+}
+
+Header *headerOf(const void *const object) {
+    return (Header *) object - 1;
+}
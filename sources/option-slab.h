@@ -0,0 +1,100 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "option.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A pool of fixed-size objects whose allocation returns an `Option`: `None` means that memory is exhausted.
+ *
+ * Each thread allocates from its own cache without synchronization, objects carved by a thread are returned to it:
+ * frees from other threads are batched and pushed onto the owner's lock-free stack with a single atomic operation.
+ * The cache of an exiting thread, together with its objects, is adopted by the next thread using the pool.
+ */
+typedef struct OptionSlab OptionSlab;
+
+/**
+ * Creates a new `OptionSlab` of objects of size bytes, rounded up to the next size class.
+ * Objects are suitably aligned for any type.
+ * Panics if memory cannot be allocated.
+ */
+extern OptionSlab *OptionSlab_new(size_t size)
+__attribute__((__warn_unused_result__, __returns_nonnull__));
+
+/**
+ * Deletes this `OptionSlab` and every object allocated from it.
+ *
+ * @attention no other thread may use this `OptionSlab` concurrently.
+ */
+extern void OptionSlab_delete(OptionSlab *self);
+
+/**
+ * Returns the size of the objects of this `OptionSlab`.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern size_t OptionSlab_objectSize(const OptionSlab *self)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Returns an `Option` wrapping an uninitialized object, to be accessed with `Option_unwrapAsMutable(...)`,
+ * or `None` if memory cannot be allocated.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern Option OptionSlab_alloc(OptionSlab *self)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Returns object to this `OptionSlab`, `NULL` is ignored.
+ * Objects allocated by another thread are batched and become reusable by their owner once the batch is flushed.
+ *
+ * @attention object must have been allocated from this `OptionSlab` and not already been freed.
+ */
+extern void OptionSlab_free(OptionSlab *self, const void *object);
+
+/**
+ * Pushes the pending batch of objects freed by the calling thread to their owner.
+ * Batches are also flushed when they are full and when the calling thread exits.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern void OptionSlab_flush(OptionSlab *self);
+
+#ifdef __cplusplus
+}
+#endif
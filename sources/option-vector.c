@@ -0,0 +1,182 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <panic/panic.h>
+#include "option-contract.h"
+#include "option-batch.h"
+#include "option-vector.h"
+
+#define WORD_BITS       64
+#define VALUE_ALIGNMENT 16
+
+struct OptionVector {
+    size_t length;
+    size_t size;
+    uint64_t *validity;
+    char *values;
+};
+
+static size_t wordsOf(size_t length);
+
+OptionVector *OptionVector_new(const size_t length, const size_t size) {
+    __Option_panicWhen(0 == size);
+    // the bitmap takes at most length + 8 bytes: one bit per slot rounded up to a word
+    const size_t header = sizeof(OptionVector) + VALUE_ALIGNMENT + sizeof(uint64_t);
+    Panic_when(size >= SIZE_MAX - header || length > (SIZE_MAX - header) / (size + 1));
+    const size_t words = wordsOf(length);
+    const size_t offset = (sizeof(OptionVector) + words * sizeof(uint64_t) + VALUE_ALIGNMENT - 1) /
+                          VALUE_ALIGNMENT * VALUE_ALIGNMENT;
+    OptionVector *self = malloc(offset + length * size);
+    Panic_when(NULL == self);
+    self->length = length;
+    self->size = size;
+    self->validity = (uint64_t *) (self + 1);
+    self->values = (char *) self + offset;
+    memset(self->validity, 0, words * sizeof(self->validity[0]));
+    return self;
+}
+
+OptionVector *OptionVector_fromArray(const Option *const items, const size_t length, const size_t size) {
+    __Option_panicWhen(NULL == items && 0 < length);
+    OptionVector *self = OptionVector_new(length, size);
+    Option_maskSome(items, length, self->validity);
+    for (size_t i = 0; i < length; i++) {
+        if (Option_isSome(items[i])) {
+            memcpy(self->values + i * size, items[i].__value, size);
+        }
+    }
+    return self;
+}
+
+void OptionVector_delete(OptionVector *const self) {
+    free(self);
+}
+
+size_t OptionVector_length(const OptionVector *const self) {
+    __Option_panicWhen(NULL == self);
+    return self->length;
+}
+
+size_t OptionVector_elementSize(const OptionVector *const self) {
+    __Option_panicWhen(NULL == self);
+    return self->size;
+}
+
+Option OptionVector_get(const OptionVector *const self, const size_t index) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(index >= self->length);
+    const bool isSome = 0 != (self->validity[index / WORD_BITS] & (UINT64_C(1) << (index % WORD_BITS)));
+    return isSome ? Option_some(self->values + index * self->size) : None;
+}
+
+void OptionVector_set(OptionVector *const self, const size_t index, const Option option) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(index >= self->length);
+    const uint64_t bit = UINT64_C(1) << (index % WORD_BITS);
+    if (Option_isSome(option)) {
+        memmove(self->values + index * self->size, option.__value, self->size);
+        self->validity[index / WORD_BITS] |= bit;
+    } else {
+        self->validity[index / WORD_BITS] &= ~bit;
+    }
+}
+
+void *OptionVector_values(OptionVector *const self) {
+    __Option_panicWhen(NULL == self);
+    return self->values;
+}
+
+const uint64_t *OptionVector_validity(const OptionVector *const self) {
+    __Option_panicWhen(NULL == self);
+    return self->validity;
+}
+
+size_t OptionVector_countSome(const OptionVector *const self) {
+    __Option_panicWhen(NULL == self);
+    const size_t words = wordsOf(self->length);
+    size_t count = 0;
+    for (size_t w = 0; w < words; w++) {
+        count += (size_t) __builtin_popcountll(self->validity[w]);
+    }
+    return count;
+}
+
+void OptionVector_map(OptionVector *const self, bool (*const f)(void *)) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(NULL == f);
+    const size_t words = wordsOf(self->length);
+    for (size_t w = 0; w < words; w++) {
+        uint64_t pending = self->validity[w], cleared = 0;
+        while (0 != pending) {
+            const unsigned bit = (unsigned) __builtin_ctzll(pending);
+            cleared |= (uint64_t) !f(self->values + (w * WORD_BITS + bit) * self->size) << bit;
+            pending &= pending - 1;
+        }
+        self->validity[w] &= ~cleared;
+    }
+}
+
+void OptionVector_filter(OptionVector *const self, bool (*const predicate)(const void *)) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(NULL == predicate);
+    const size_t words = wordsOf(self->length);
+    for (size_t w = 0; w < words; w++) {
+        uint64_t pending = self->validity[w], cleared = 0;
+        while (0 != pending) {
+            const unsigned bit = (unsigned) __builtin_ctzll(pending);
+            cleared |= (uint64_t) !predicate(self->values + (w * WORD_BITS + bit) * self->size) << bit;
+            pending &= pending - 1;
+        }
+        self->validity[w] &= ~cleared;
+    }
+}
+
+void OptionVector_alt(OptionVector *const self, const OptionVector *const other) {
+    __Option_panicWhen(NULL == self);
+    __Option_panicWhen(NULL == other);
+    __Option_panicWhen(self->length != other->length || self->size != other->size);
+    const size_t words = wordsOf(self->length);
+    for (size_t w = 0; w < words; w++) {
+        const uint64_t missing = ~self->validity[w] & other->validity[w];
+        uint64_t pending = missing;
+        while (0 != pending) {
+            const size_t index = w * WORD_BITS + (size_t) __builtin_ctzll(pending);
+            memcpy(self->values + index * self->size, other->values + index * self->size, self->size);
+            pending &= pending - 1;
+        }
+        self->validity[w] |= missing;
+    }
+}
+
+/*
+ *
+ */
+size_t wordsOf(const size_t length) {
+    return (length + WORD_BITS - 1) / WORD_BITS;
+}
@@ -0,0 +1,166 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "option.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A fixed-length columnar container of optional values of a fixed size: the values are stored inline in a contiguous
+ * buffer next to a packed validity bitmap, where bit `i % 64` of word `i / 64` is set if slot i is wrapping a value.
+ * A slot costs its element size plus one bit, instead of the pointer of an `Option` and the pointed storage.
+ * Bulk operations process the bitmap a 64-bit word at a time, skipping empty words entirely.
+ *
+ * Values move in and out as `Option`s wrapping a pointer to an element: `OptionVector_set(...)` copies the pointed
+ * element into the buffer, `OptionVector_get(...)` returns a pointer into the buffer.
+ */
+typedef struct OptionVector OptionVector;
+
+/**
+ * Creates a new `OptionVector` of length slots of size bytes, all of them `None`.
+ * Elements are aligned for any type whose alignment divides 16 and size.
+ * Panics if the vector would not fit the address space or if memory cannot be allocated.
+ *
+ * @attention size must not be 0.
+ */
+extern OptionVector *OptionVector_new(size_t length, size_t size)
+__attribute__((__warn_unused_result__, __returns_nonnull__));
+
+/**
+ * Creates a new `OptionVector` of elements of size bytes holding a copy of the elements wrapped by items.
+ * Panics if memory cannot be allocated.
+ *
+ * @attention items must not be `NULL` unless length is 0.
+ * @attention size must not be 0.
+ */
+extern OptionVector *OptionVector_fromArray(const Option *items, size_t length, size_t size)
+__attribute__((__warn_unused_result__, __returns_nonnull__));
+
+/**
+ * Deletes this `OptionVector`.
+ */
+extern void OptionVector_delete(OptionVector *self);
+
+/**
+ * Returns the number of slots of this `OptionVector`.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern size_t OptionVector_length(const OptionVector *self)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Returns the size of the elements of this `OptionVector`.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern size_t OptionVector_elementSize(const OptionVector *self)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Returns an `Option` wrapping a pointer to the element at index, `None` if the slot is empty.
+ * The pointer is valid until this `OptionVector` is deleted, use `Option_unwrapAsMutable(...)` to update it in place.
+ *
+ * @attention self must not be `NULL`.
+ * @attention index must be less than the length of this `OptionVector`.
+ */
+extern Option OptionVector_get(const OptionVector *self, size_t index)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Copies the element wrapped by option at index, or empties the slot if option is `None`.
+ *
+ * @attention self must not be `NULL`.
+ * @attention index must be less than the length of this `OptionVector`.
+ */
+extern void OptionVector_set(OptionVector *self, size_t index, Option option);
+
+/**
+ * Returns the buffer of the elements of this `OptionVector`, made of length elements.
+ * Empty slots hold unspecified bytes.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern void *OptionVector_values(OptionVector *self)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Returns the validity bitmap of this `OptionVector`, made of `(length + 63) / 64` words.
+ * Bits past length are always zero.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern const uint64_t *OptionVector_validity(const OptionVector *self)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Returns the number of slots wrapping a value.
+ *
+ * @attention self must not be `NULL`.
+ */
+extern size_t OptionVector_countSome(const OptionVector *self)
+__attribute__((__warn_unused_result__));
+
+/**
+ * In-place map of every slot wrapping a value: f updates the element it is given,
+ * slots for which f returns `false` become `None`.
+ *
+ * @attention self must not be `NULL`.
+ * @attention f must not be `NULL`.
+ */
+extern void OptionVector_map(OptionVector *self, bool f(void *element));
+
+/**
+ * In-place filter: slots whose value does not satisfy predicate become `None`.
+ *
+ * @attention self must not be `NULL`.
+ * @attention predicate must not be `NULL`.
+ */
+extern void OptionVector_filter(OptionVector *self, bool predicate(const void *element));
+
+/**
+ * In-place `Option_alt(...)` of every slot: `None` slots of this `OptionVector` take a copy of the slot of other.
+ *
+ * @attention self must not be `NULL`.
+ * @attention other must not be `NULL` and must have the same length and element size of this `OptionVector`.
+ */
+extern void OptionVector_alt(OptionVector *self, const OptionVector *other);
+
+#ifdef __cplusplus
+}
+#endif
@@ -26,14 +26,18 @@ OTHER DEALINGS IN THE SOFTWARE.
  */
 
 #include <assert.h>
+#include <stdarg.h>
 #include <stddef.h>
 #include <panic/panic.h>
+#include "option-contract.h"
 #include "option.h"
 
+#if !defined(OPTION_HEADER_ONLY)
 const Option None = {.__value=NULL};
+#endif
 
 Option Option_some(const void *value) {
-    Panic_when(NULL == value);
+    __Option_panicWhen(NULL == value);
     return (Option) {.__value=value};
 }
 
@@ -50,13 +54,13 @@ bool Option_isSome(const Option self) {
 }
 
 Option Option_map(const Option self, const void *(*const f)(const void *)) {
-    Panic_when(NULL == f);
-    return Option_isNone(self) ? self : Option_fromNullable(f(Option_unwrap(self)));
+    __Option_panicWhen(NULL == f);
+    return Option_isNone(self) ? self : Option_fromNullable(f(self.__value));
 }
 
 Option Option_chain(const Option self, Option (*const f)(const void *)) {
-    Panic_when(NULL == f);
-    return Option_isNone(self) ? self : f(Option_unwrap(self));
+    __Option_panicWhen(NULL == f);
+    return Option_isNone(self) ? self : f(self.__value);
 }
 
 Option Option_alt(const Option self, const Option other) {
@@ -64,10 +68,25 @@ Option Option_alt(const Option self, const Option other) {
 }
 
 Option Option_orElse(const Option self, Option (*const f)(void)) {
-    Panic_when(NULL == f);
+    __Option_panicWhen(NULL == f);
     return Option_isSome(self) ? self : f();
 }
 
+Option Option_mapWith(const Option self, const void *(*const f)(void *, const void *), void *const context) {
+    __Option_panicWhen(NULL == f);
+    return Option_isNone(self) ? self : Option_fromNullable(f(context, self.__value));
+}
+
+Option Option_chainWith(const Option self, Option (*const f)(void *, const void *), void *const context) {
+    __Option_panicWhen(NULL == f);
+    return Option_isNone(self) ? self : f(context, self.__value);
+}
+
+Option Option_orElseWith(const Option self, Option (*const f)(void *), void *const context) {
+    __Option_panicWhen(NULL == f);
+    return Option_isSome(self) ? self : f(context);
+}
+
 const void *__Option_unwrap(const char *const file, const int line, const Option self) {
     assert(NULL != file);
     if (Option_isNone(self)) {
@@ -106,3 +125,47 @@ __Option_expectAsMutable(const char *const file, const int line, const Option se
     }
     return (void *) self.__value;
 }
+
+void __Option_panicAt(const OptionCallSite *const site) {
+    assert(NULL != site);
+    __Panic_terminate(OptionCallSite_file(site), site->__line, "%s", "Unable to unwrap value");
+}
+
+void __Option_expectAt(const OptionCallSite *const site, const char *const format, ...) {
+    assert(NULL != site);
+    assert(NULL != format);
+    va_list args;
+    va_start(args, format);
+    __Panic_vterminate(OptionCallSite_file(site), site->__line, format, args);
+}
+
+const char *OptionCallSite_file(const OptionCallSite *const site) {
+    assert(NULL != site);
+    return (const char *) &site->__file + site->__file;
+}
+
+int OptionCallSite_line(const OptionCallSite *const site) {
+    assert(NULL != site);
+    return site->__line;
+}
+
+#if defined(__ELF__)
+
+extern const OptionCallSite __start_option_call_sites[] __attribute__((__weak__));
+extern const OptionCallSite __stop_option_call_sites[] __attribute__((__weak__));
+
+size_t Option_callSites(const OptionCallSite **const sites) {
+    assert(NULL != sites);
+    *sites = __start_option_call_sites;
+    return NULL == __start_option_call_sites ? 0 : (size_t) (__stop_option_call_sites - __start_option_call_sites);
+}
+
+#else
+
+size_t Option_callSites(const OptionCallSite **const sites) {
+    assert(NULL != sites);
+    *sites = NULL;
+    return 0;
+}
+
+#endif
@@ -27,6 +27,8 @@ OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 #if !(defined(__GNUC__) || defined(__clang__))
@@ -44,6 +46,17 @@ extern "C" {
 #define OPTION_VERSION_IS_RELEASE   0
 #define OPTION_VERSION_HEX          0x010000
 
+/**
+ * Defining `OPTION_HEADER_ONLY` before including this header turns every function of this module into a `static inline`
+ * definition, letting the compiler fold chains of combinators into straight-line code.
+ * The `option` archive remains available for ABI users, the two modes must not be mixed in the same translation unit.
+ */
+#if defined(OPTION_HEADER_ONLY)
+#define OPTION_API                  static inline
+#else
+#define OPTION_API                  extern
+#endif
+
 /**
  * An option-type or maybe-type is a polymorphic type that represents encapsulation of an optional value;
  * e.g. it is used as the return type of functions which may or may not return a meaningful value when they are applied.
@@ -66,33 +79,37 @@ typedef struct {
 /**
  * The `None` instance used to represent the absence of a value.
  */
+#if defined(OPTION_HEADER_ONLY)
+static const Option None = {.__value=NULL};
+#else
 extern const Option None;
+#endif
 
 /**
  * Constructs a new `Option` wrapping a value.
  *
  * @attention value must not be `NULL`.
  */
-extern Option Option_some(const void *value)
+OPTION_API Option Option_some(const void *value)
 __attribute__((__warn_unused_result__));
 
 /**
  * Constructs a new `Option` from a nullable pointer.
  * If the value is `NULL`, returns `None`, otherwise returns the value wrapped in a `Option`
  */
-extern Option Option_fromNullable(const void *value)
+OPTION_API Option Option_fromNullable(const void *value)
 __attribute__((__warn_unused_result__));
 
 /**
  * Returns `true` if this `Option` is `None`, `false` otherwise.
  */
-extern bool Option_isNone(Option self)
+OPTION_API bool Option_isNone(Option self)
 __attribute__((__warn_unused_result__));
 
 /**
  * Returns `true` if this `Option` is wrapping a value, `false` otherwise.
  */
-extern bool Option_isSome(Option self)
+OPTION_API bool Option_isSome(Option self)
 __attribute__((__warn_unused_result__));
 
 /**
@@ -101,7 +118,7 @@ __attribute__((__warn_unused_result__));
  *
  * @attention f must not be `NULL`.
  */
-extern Option Option_map(Option self, const void *f(const void *))
+OPTION_API Option Option_map(Option self, const void *f(const void *))
 __attribute__((__warn_unused_result__));
 
 /**
@@ -109,13 +126,13 @@ __attribute__((__warn_unused_result__));
  *
  * @attention f must not be `NULL`.
  */
-extern Option Option_chain(Option self, Option f(const void *))
+OPTION_API Option Option_chain(Option self, Option f(const void *))
 __attribute__((__warn_unused_result__));
 
 /**
  * If this `Option` is wrapping a value then it will be returned, else the next `Option` will be returned.
  */
-extern Option Option_alt(Option self, Option other)
+OPTION_API Option Option_alt(Option self, Option other)
 __attribute__((__warn_unused_result__));
 
 /**
@@ -123,9 +140,100 @@ __attribute__((__warn_unused_result__));
  *
  * @attention f must not be `NULL`.
  */
-extern Option Option_orElse(Option self, Option f(void))
+OPTION_API Option Option_orElse(Option self, Option f(void))
+__attribute__((__warn_unused_result__));
+
+/**
+ * Like `Option_map(...)` but context is forwarded to f, allowing to carry state without globals.
+ *
+ * @attention f must not be `NULL`.
+ */
+OPTION_API Option Option_mapWith(Option self, const void *f(void *context, const void *value), void *context)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Like `Option_chain(...)` but context is forwarded to f, allowing to carry state without globals.
+ *
+ * @attention f must not be `NULL`.
+ */
+OPTION_API Option Option_chainWith(Option self, Option f(void *context, const void *value), void *context)
 __attribute__((__warn_unused_result__));
 
+/**
+ * Like `Option_orElse(...)` but context is forwarded to f, allowing to carry state without globals.
+ *
+ * @attention f must not be `NULL`.
+ */
+OPTION_API Option Option_orElseWith(Option self, Option f(void *context), void *context)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Describes a call site of `Option_unwrap(...)`, `Option_expect(...)` and their mutable variants.
+ *
+ * When `OPTION_CALL_SITES` is defined, each call site stores a static descriptor in the dedicated
+ * `option_call_sites` linker section: the success path is an inline `NULL` test that passes no argument at all
+ * and only the failing branch calls an out-of-line reporter with a pointer to the descriptor.
+ * In this mode the format arguments of `Option_expect(...)` are evaluated only if the `Option` is `None`.
+ *
+ * Descriptors hold no pointers, so they need no load-time relocations in position-independent executables: the file
+ * name is stored as an offset from the descriptor itself and file names are merged with the other string literals.
+ * Descriptors are emitted by inline assembly, this mode is available on x86-64 and AArch64 ELF targets only
+ * and falls back to passing the file and line elsewhere.
+ * Call sites whose failing branch is removed by the optimizer have no descriptor, those duplicated by the optimizer
+ * (e.g. by loop unrolling) may have more than one.
+ *
+ * @attention this struct must be treated as opaque, use `OptionCallSite_file(...)` and `OptionCallSite_line(...)`.
+ */
+typedef struct {
+    int32_t __file;
+    int32_t __line;
+} OptionCallSite;
+
+/**
+ * Returns the name of the file of this call site.
+ *
+ * @attention site must not be `NULL`.
+ */
+OPTION_API const char *OptionCallSite_file(const OptionCallSite *site)
+__attribute__((__warn_unused_result__, __nonnull__, __returns_nonnull__));
+
+/**
+ * Returns the line of this call site.
+ *
+ * @attention site must not be `NULL`.
+ */
+OPTION_API int OptionCallSite_line(const OptionCallSite *site)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Stores in sites the descriptors linked in the `option_call_sites` section and returns their number.
+ * Only available on ELF targets, elsewhere returns 0.
+ *
+ * @attention sites must not be `NULL`.
+ */
+OPTION_API size_t Option_callSites(const OptionCallSite **sites)
+__attribute__((__nonnull__));
+
+#if defined(OPTION_CALL_SITES) && defined(__ELF__) && (defined(__x86_64__) || defined(__aarch64__))
+#define __OPTION_CALL_SITES_TABLE 1
+#endif
+
+#if defined(__OPTION_CALL_SITES_TABLE)
+
+#define Option_unwrap(self) \
+    __Option_unwrapAt(const void *, (self), __Option_panicAt(__site))
+
+#define Option_unwrapAsMutable(self) \
+    __Option_unwrapAt(void *, (self), __Option_panicAt(__site))
+
+#define Option_expect(self, ...) \
+    __Option_unwrapAt(const void *, (self), __Option_expectAt(__site, __VA_ARGS__))
+
+#define Option_expectAsMutable(self, ...) \
+    __Option_unwrapAt(void *, (self), __Option_expectAt(__site, __VA_ARGS__))
+
+#else
+
 /**
  * Unwraps the value of this `Option` if this `Option` is wrapping a value else panics.
  */
@@ -150,30 +258,94 @@ __attribute__((__warn_unused_result__));
 #define Option_expectAsMutable(self, ...) \
     __Option_expectAsMutable((__FILE__), (__LINE__), (self), __VA_ARGS__)
 
+#endif
+
+#if defined(__OPTION_CALL_SITES_TABLE)
+
+#if defined(__x86_64__)
+#define __OPTION_CALL_SITE_ADDRESS \
+    "lea 1b(%%rip), %0\n"
+#elif defined(__aarch64__)
+#define __OPTION_CALL_SITE_ADDRESS                                                                                     \
+    "adrp %0, 1b\n"                                                                                                    \
+    "add %0, %0, :lo12:1b\n"
+#endif
+
+/**
+ * Emits the descriptor of the enclosing call site and yields its address: only the failing branch executes it.
+ * The statement is not `volatile` so that the compiler is free to move the failing branch to the cold section.
+ *
+ * @attention this macro must be treated as opaque therefore must not be used directly.
+ */
+#define __Option_callSite()                                                                                            \
+    (__extension__ ({                                                                                                  \
+        const OptionCallSite *__descriptor;                                                                            \
+        __asm__(                                                                                                       \
+                ".pushsection option_call_sites, \"a\"\n"                                                              \
+                ".balign 4\n"                                                                                          \
+                "1: .long %c1 - 1b\n"                                                                                  \
+                ".long %c2\n"                                                                                          \
+                ".popsection\n"                                                                                        \
+                __OPTION_CALL_SITE_ADDRESS                                                                             \
+                : "=r"(__descriptor) : "i"(__FILE__), "i"(__LINE__));                                                  \
+        __descriptor;                                                                                                  \
+    }))
+
+/**
+ * @attention this macro must be treated as opaque therefore must not be used directly.
+ */
+#define __Option_unwrapAt(Type, self, onNone)                                                                          \
+    (__extension__ ({                                                                                                  \
+        const Option __self = (self);                                                                                  \
+        if (__builtin_expect(NULL == __self.__value, 0)) {                                                             \
+            const OptionCallSite *const __site = __Option_callSite();                                                  \
+            onNone;                                                                                                    \
+        }                                                                                                              \
+        (Type) __self.__value;                                                                                         \
+    }))
+
+#endif
+
 /**
  * @attention this function must be treated as opaque therefore must not be called directly.
  */
-extern const void *__Option_unwrap(const char *file, int line, Option self)
+OPTION_API void __Option_panicAt(const OptionCallSite *site)
+__attribute__((__cold__, __noreturn__, __nonnull__));
+
+/**
+ * @attention this function must be treated as opaque therefore must not be called directly.
+ */
+OPTION_API void __Option_expectAt(const OptionCallSite *site, const char *format, ...)
+__attribute__((__cold__, __noreturn__, __nonnull__(1, 2), __format__(__printf__, 2, 3)));
+
+/**
+ * @attention this function must be treated as opaque therefore must not be called directly.
+ */
+OPTION_API const void *__Option_unwrap(const char *file, int line, Option self)
 __attribute__((__nonnull__(1)));
 
 /**
  * @attention this function must be treated as opaque therefore must not be called directly.
  */
-extern void *__Option_unwrapAsMutable(const char *file, int line, Option self)
+OPTION_API void *__Option_unwrapAsMutable(const char *file, int line, Option self)
 __attribute__((__nonnull__(1)));
 
 /**
  * @attention this function must be treated as opaque therefore must not be called directly.
  */
-extern const void *__Option_expect(const char *file, int line, Option self, const char *format, ...)
+OPTION_API const void *__Option_expect(const char *file, int line, Option self, const char *format, ...)
 __attribute__((__nonnull__(1, 4), __format__(__printf__, 4, 5)));
 
 /**
  * @attention this function must be treated as opaque therefore must not be called directly.
  */
-extern void *__Option_expectAsMutable(const char *file, int line, Option self, const char *format, ...)
+OPTION_API void *__Option_expectAsMutable(const char *file, int line, Option self, const char *format, ...)
 __attribute__((__nonnull__(1, 4), __format__(__printf__, 4, 5)));
 
 #ifdef __cplusplus
 }
 #endif
+
+#if defined(OPTION_HEADER_ONLY)
+#include "option.c"
+#endif
@@ -0,0 +1,516 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <optional>
+#include <type_traits>
+#include <panic/panic.h>
+#include "option.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+/**
+ * C++17 counterpart of `Option`: `option::Option<T>` stores T inline, supports move-only types and is usable in
+ * constant expressions when T is trivially destructible. Everything is defined in this header so that chains of
+ * combinators inline down to plain branches.
+ *
+ * `Option<T *>` uses `nullptr` as niche for `None`, so `sizeof(Option<T *>) == sizeof(T *)`, like `Option`;
+ * `Option<const T *>` converts losslessly from and to the C `Option`. Every `Option<T>` converts to and from
+ * `std::optional<T>`, losslessly except for pointers: `std::optional<T *>{nullptr}` holds a value but becomes `None`.
+ *
+ * The combinators follow the C names: `map`, `chain`, `alt` and `orElse`.
+ * The template must be spelled `option::Option`, a `using namespace option` makes it ambiguous with the C `Option`.
+ */
+namespace option {
+
+/**
+ * The type of `option::none`, the `None` instance usable with any `Option<T>`.
+ */
+struct NoneType {
+    constexpr explicit NoneType(int) noexcept {}
+};
+
+inline constexpr NoneType none{0};
+
+template<class T>
+class Option;
+
+namespace __detail {
+
+template<class T>
+struct IsOption : std::false_type {
+};
+
+template<class T>
+struct IsOption<Option<T>> : std::true_type {
+};
+
+[[noreturn]] inline void panic(const char *const file, const int line, const char *const message) {
+    __Panic_terminate(file, line, "%s", message);
+}
+
+/**
+ * @attention this struct must be treated as opaque therefore its members must not be accessed directly.
+ */
+template<class T, bool = std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>>
+struct Storage {
+    union {
+        char __empty;
+        T __value;
+    };
+    bool __isSome;
+
+    constexpr Storage() noexcept: __empty(), __isSome(false) {}
+
+    template<class... Args>
+    constexpr explicit Storage(std::in_place_t, Args &&... args) : __value(std::forward<Args>(args)...), __isSome(true) {}
+
+    constexpr bool isSome() const noexcept { return __isSome; }
+
+    constexpr T &get() noexcept { return __value; }
+
+    constexpr const T &get() const noexcept { return __value; }
+};
+
+/**
+ * Non-trivial payloads are copied, moved and destroyed explicitly.
+ */
+template<class T>
+struct Storage<T, false> {
+    union {
+        char __empty;
+        T __value;
+    };
+    bool __isSome;
+
+    Storage() noexcept: __empty(), __isSome(false) {}
+
+    template<class... Args>
+    explicit Storage(std::in_place_t, Args &&... args) : __value(std::forward<Args>(args)...), __isSome(true) {}
+
+    Storage(const Storage &other) : __empty(), __isSome(false) {
+        if (other.__isSome) {
+            emplace(other.__value);
+        }
+    }
+
+    Storage(Storage &&other) noexcept(std::is_nothrow_move_constructible_v<T>) : __empty(), __isSome(false) {
+        if (other.__isSome) {
+            emplace(std::move(other.__value));
+        }
+    }
+
+    Storage &operator=(const Storage &other) {
+        if (this != &other) {
+            reset();
+            if (other.__isSome) {
+                emplace(other.__value);
+            }
+        }
+        return *this;
+    }
+
+    Storage &operator=(Storage &&other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            reset();
+            if (other.__isSome) {
+                emplace(std::move(other.__value));
+            }
+        }
+        return *this;
+    }
+
+    ~Storage() {
+        reset();
+    }
+
+    bool isSome() const noexcept { return __isSome; }
+
+    T &get() noexcept { return __value; }
+
+    const T &get() const noexcept { return __value; }
+
+    template<class... Args>
+    void emplace(Args &&... args) {
+        ::new(static_cast<void *>(std::addressof(__value))) T(std::forward<Args>(args)...);
+        __isSome = true;
+    }
+
+    void reset() noexcept {
+        if (__isSome) {
+            __value.~T();
+            __isSome = false;
+        }
+    }
+};
+
+/**
+ * Pointers reserve `nullptr` to represent `None`.
+ */
+template<class T>
+struct Storage<T *, true> {
+    T *__value;
+
+    constexpr Storage() noexcept: __value(nullptr) {}
+
+    constexpr explicit Storage(std::in_place_t, T *const value) : __value(value) {
+        if (nullptr == value) {
+            panic(__FILE__, __LINE__, "(nullptr == value) evaluates to `true`");
+        }
+    }
+
+    constexpr bool isSome() const noexcept { return nullptr != __value; }
+
+    constexpr T *&get() noexcept { return __value; }
+
+    constexpr T *const &get() const noexcept { return __value; }
+};
+
+/**
+ * Empty base deleting the copy and move members of `Option<T>` that T does not support, as the user-declared ones
+ * of `Storage<T, false>` would otherwise make every `Option<T>` look copyable.
+ */
+template<bool Copy, bool Move>
+struct EnableCopyMove {
+};
+
+template<>
+struct EnableCopyMove<false, true> {
+    constexpr EnableCopyMove() noexcept = default;
+    EnableCopyMove(const EnableCopyMove &) = delete;
+    constexpr EnableCopyMove(EnableCopyMove &&) noexcept = default;
+    EnableCopyMove &operator=(const EnableCopyMove &) = delete;
+    constexpr EnableCopyMove &operator=(EnableCopyMove &&) noexcept = default;
+};
+
+template<>
+struct EnableCopyMove<true, false> {
+    constexpr EnableCopyMove() noexcept = default;
+    constexpr EnableCopyMove(const EnableCopyMove &) noexcept = default;
+    EnableCopyMove(EnableCopyMove &&) = delete;
+    constexpr EnableCopyMove &operator=(const EnableCopyMove &) noexcept = default;
+    EnableCopyMove &operator=(EnableCopyMove &&) = delete;
+};
+
+template<>
+struct EnableCopyMove<false, false> {
+    constexpr EnableCopyMove() noexcept = default;
+    EnableCopyMove(const EnableCopyMove &) = delete;
+    EnableCopyMove(EnableCopyMove &&) = delete;
+    EnableCopyMove &operator=(const EnableCopyMove &) = delete;
+    EnableCopyMove &operator=(EnableCopyMove &&) = delete;
+};
+
+} // namespace __detail
+
+/**
+ * Constructs a new `Option` wrapping value, file and line locate the caller in the panic report.
+ *
+ * @attention value must not be `nullptr` if it is a pointer.
+ */
+template<class T>
+constexpr Option<std::decay_t<T>> some(T &&value,
+                                       const char *const file = __builtin_FILE(), const int line = __builtin_LINE()) {
+    if constexpr (std::is_pointer_v<std::decay_t<T>>) {
+        if (__builtin_expect(nullptr == value, 0)) {
+            __detail::panic(file, line, "(nullptr == value) evaluates to `true`");
+        }
+    }
+    return Option<std::decay_t<T>>(std::in_place, std::forward<T>(value));
+}
+
+/**
+ * Constructs a new `Option` from a nullable pointer.
+ * If the value is `nullptr`, returns `None`, otherwise returns the value wrapped in a `Option`.
+ */
+template<class T>
+constexpr Option<T *> fromNullable(T *const value) noexcept {
+    return nullptr == value ? Option<T *>() : Option<T *>(std::in_place, value);
+}
+
+template<class T>
+class Option : private __detail::EnableCopyMove<std::is_copy_constructible_v<T>, std::is_move_constructible_v<T>> {
+    static_assert(!std::is_reference_v<T>, "Option of a reference is not allowed, use a pointer instead");
+    static_assert(!std::is_same_v<std::remove_cv_t<T>, NoneType>, "Option of NoneType is not allowed");
+
+    template<class U>
+    friend class Option;
+
+    __detail::Storage<T> storage;
+
+    /*
+     * Wraps the result of a mapping function: like `Option_map(...)`, a `nullptr` result is `None`.
+     */
+    template<class U>
+    static constexpr Option<std::decay_t<U>> wrap(U &&value) {
+        if constexpr (std::is_pointer_v<std::decay_t<U>>) {
+            return fromNullable(value);
+        } else {
+            return some(std::forward<U>(value));
+        }
+    }
+
+public:
+    using ValueType = T;
+
+    /**
+     * Constructs `None`.
+     */
+    constexpr Option() noexcept = default;
+
+    /**
+     * Constructs `None`.
+     */
+    constexpr Option(NoneType) noexcept {}
+
+    /**
+     * Constructs a new `Option` wrapping the value constructed in place from args.
+     */
+    template<class... Args>
+    constexpr explicit Option(std::in_place_t, Args &&... args) : storage(std::in_place, std::forward<Args>(args)...) {}
+
+    /**
+     * Converts from `std::optional`, a `nullptr` pointer is `None` so the round trip through `toStd()` is lossy.
+     */
+    constexpr Option(const std::optional<T> &other) : Option() {
+        if (other.has_value()) {
+            *this = wrap(*other);
+        }
+    }
+
+    /**
+     * Converts from `std::optional`, a `nullptr` pointer is `None` so the round trip through `toStd()` is lossy.
+     */
+    constexpr Option(std::optional<T> &&other) : Option() {
+        if (other.has_value()) {
+            *this = wrap(std::move(*other));
+        }
+    }
+
+    /**
+     * Converts from the C `Option`, only available for `Option<const void *>` and `Option<const U *>`.
+     */
+    template<class U = T, class = std::enable_if_t<std::is_pointer_v<U> && std::is_const_v<std::remove_pointer_t<U>>>>
+    constexpr explicit Option(const ::Option &other) noexcept : Option(fromNullable(static_cast<T>(other.__value))) {}
+
+    /**
+     * Converts to the C `Option`, only available for `Option<U *>`.
+     */
+    template<class U = T, class = std::enable_if_t<std::is_pointer_v<U>>>
+    constexpr ::Option toC() const noexcept {
+        return ::Option{storage.get()};
+    }
+
+    /**
+     * Returns a C `Option` borrowing the wrapped value, `None` if this `Option` is `None`.
+     *
+     * @attention the returned `Option` must not outlive this `Option`.
+     */
+    constexpr ::Option borrow() const & noexcept {
+        return ::Option{isSome() ? static_cast<const void *>(std::addressof(storage.get())) : nullptr};
+    }
+
+    /**
+     * Converts to `std::optional`.
+     */
+    constexpr std::optional<T> toStd() const & {
+        return isSome() ? std::optional<T>(storage.get()) : std::nullopt;
+    }
+
+    /**
+     * Converts to `std::optional`.
+     */
+    constexpr std::optional<T> toStd() && {
+        return isSome() ? std::optional<T>(std::move(storage.get())) : std::nullopt;
+    }
+
+    /**
+     * Returns `true` if this `Option` is wrapping a value, `false` otherwise.
+     */
+    [[nodiscard]] constexpr bool isSome() const noexcept {
+        return storage.isSome();
+    }
+
+    /**
+     * Returns `true` if this `Option` is `None`, `false` otherwise.
+     */
+    [[nodiscard]] constexpr bool isNone() const noexcept {
+        return !storage.isSome();
+    }
+
+    constexpr explicit operator bool() const noexcept {
+        return storage.isSome();
+    }
+
+    /**
+     * Returns an `Option` wrapping the result of f applied to the value of this `Option` if this `Option` is not `None` else `None`.
+     * If f returns a `nullptr` pointer, returns `None`.
+     */
+    template<class F>
+    [[nodiscard]] constexpr auto map(F &&f) const & {
+        using Result = Option<std::decay_t<std::invoke_result_t<F, const T &>>>;
+        return isSome() ? Result::wrap(std::forward<F>(f)(storage.get())) : Result();
+    }
+
+    template<class F>
+    [[nodiscard]] constexpr auto map(F &&f) && {
+        using Result = Option<std::decay_t<std::invoke_result_t<F, T &&>>>;
+        return isSome() ? Result::wrap(std::forward<F>(f)(std::move(storage.get()))) : Result();
+    }
+
+    /**
+     * Chains several possibly failing computations: f must return an `Option`.
+     */
+    template<class F>
+    [[nodiscard]] constexpr auto chain(F &&f) const & {
+        using Result = std::decay_t<std::invoke_result_t<F, const T &>>;
+        static_assert(__detail::IsOption<Result>::value, "f must return an Option");
+        return isSome() ? std::forward<F>(f)(storage.get()) : Result();
+    }
+
+    template<class F>
+    [[nodiscard]] constexpr auto chain(F &&f) && {
+        using Result = std::decay_t<std::invoke_result_t<F, T &&>>;
+        static_assert(__detail::IsOption<Result>::value, "f must return an Option");
+        return isSome() ? std::forward<F>(f)(std::move(storage.get())) : Result();
+    }
+
+    /**
+     * If this `Option` is wrapping a value then it will be returned, else other will be returned.
+     */
+    [[nodiscard]] constexpr Option alt(Option other) const & {
+        return isSome() ? *this : std::move(other);
+    }
+
+    [[nodiscard]] constexpr Option alt(Option other) && {
+        return isSome() ? std::move(*this) : std::move(other);
+    }
+
+    /**
+     * Lazy version of `alt(...)`: f must return an `Option<T>`.
+     */
+    template<class F>
+    [[nodiscard]] constexpr Option orElse(F &&f) const & {
+        return isSome() ? *this : Option(std::forward<F>(f)());
+    }
+
+    template<class F>
+    [[nodiscard]] constexpr Option orElse(F &&f) && {
+        return isSome() ? std::move(*this) : Option(std::forward<F>(f)());
+    }
+
+    /**
+     * Unwraps the value of this `Option` if this `Option` is wrapping a value else panics.
+     */
+    constexpr T &unwrap(const char *const file = __builtin_FILE(), const int line = __builtin_LINE()) & {
+        if (__builtin_expect(isNone(), 0)) {
+            __detail::panic(file, line, "Unable to unwrap value");
+        }
+        return storage.get();
+    }
+
+    constexpr const T &unwrap(const char *const file = __builtin_FILE(), const int line = __builtin_LINE()) const & {
+        if (__builtin_expect(isNone(), 0)) {
+            __detail::panic(file, line, "Unable to unwrap value");
+        }
+        return storage.get();
+    }
+
+    constexpr T unwrap(const char *const file = __builtin_FILE(), const int line = __builtin_LINE()) && {
+        if (__builtin_expect(isNone(), 0)) {
+            __detail::panic(file, line, "Unable to unwrap value");
+        }
+        return std::move(storage.get());
+    }
+
+    /**
+     * Unwraps the value of this `Option` if this `Option` is wrapping a value else panics printing message.
+     */
+    constexpr T &expect(const char *const message,
+                        const char *const file = __builtin_FILE(), const int line = __builtin_LINE()) & {
+        if (__builtin_expect(isNone(), 0)) {
+            __detail::panic(file, line, message);
+        }
+        return storage.get();
+    }
+
+    constexpr const T &expect(const char *const message,
+                              const char *const file = __builtin_FILE(), const int line = __builtin_LINE()) const & {
+        if (__builtin_expect(isNone(), 0)) {
+            __detail::panic(file, line, message);
+        }
+        return storage.get();
+    }
+
+    constexpr T expect(const char *const message,
+                       const char *const file = __builtin_FILE(), const int line = __builtin_LINE()) && {
+        if (__builtin_expect(isNone(), 0)) {
+            __detail::panic(file, line, message);
+        }
+        return std::move(storage.get());
+    }
+
+    /**
+     * Returns the wrapped value if any else fallback.
+     */
+    template<class U>
+    [[nodiscard]] constexpr T unwrapOr(U &&fallback) const & {
+        return isSome() ? storage.get() : static_cast<T>(std::forward<U>(fallback));
+    }
+
+    template<class U>
+    [[nodiscard]] constexpr T unwrapOr(U &&fallback) && {
+        return isSome() ? std::move(storage.get()) : static_cast<T>(std::forward<U>(fallback));
+    }
+};
+
+template<class T, class U>
+constexpr bool operator==(const Option<T> &a, const Option<U> &b) {
+    return a.isSome() == b.isSome() && (a.isNone() || a.unwrap() == b.unwrap());
+}
+
+template<class T, class U>
+constexpr bool operator!=(const Option<T> &a, const Option<U> &b) {
+    return !(a == b);
+}
+
+template<class T>
+constexpr bool operator==(const Option<T> &a, NoneType) noexcept {
+    return a.isNone();
+}
+
+template<class T>
+constexpr bool operator!=(const Option<T> &a, NoneType) noexcept {
+    return a.isSome();
+}
+
+} // namespace option
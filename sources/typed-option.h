@@ -0,0 +1,235 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <panic/panic.h>
+#include "option-contract.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+/**
+ * Typed options store the wrapped value inline instead of behind a `const void *`,
+ * they are returned by value (in registers for small types) so no storage has to outlive the call.
+ *
+ * `OPTION_DEFINE(double, OptionDouble)` emits the `OptionDouble` type together with:
+ *  - `OptionDouble OptionDouble_some(double value)`
+ *  - `OptionDouble OptionDouble_none(void)`
+ *  - `bool OptionDouble_isSome(OptionDouble self)`
+ *  - `bool OptionDouble_isNone(OptionDouble self)`
+ *  - `OptionDouble OptionDouble_map(OptionDouble self, double f(double))`
+ *  - `OptionDouble OptionDouble_chain(OptionDouble self, OptionDouble f(double))`
+ *  - `OptionDouble OptionDouble_alt(OptionDouble self, OptionDouble other)`
+ *  - `OptionDouble OptionDouble_orElse(OptionDouble self, OptionDouble f(void))`
+ *
+ * Values are extracted with `OPTION_UNWRAP(OptionDouble, self)` and `OPTION_EXPECT(OptionDouble, self, ...)`.
+ *
+ * Niche-encoded options (`OPTION_DEFINE_NICHE` and `OPTION_DEFINE_SENTINEL`) reserve one value of the wrapped type
+ * to represent `None`, the same way `Option` reserves `NULL`, so that `sizeof(Name) == sizeof(Type)`.
+ * They additionally provide `Name Name_fromRaw(Type value)` which, like `Option_fromNullable`, returns `None`
+ * if value is the reserved one; likewise `Name_map` returns `None` if f returns the reserved value.
+ * Every function is `static inline`, so the macro can be used in headers as well as in translation units.
+ */
+
+/**
+ * Defines a typed option named Name wrapping values of type Type.
+ *
+ * @attention Type must be a complete type that can be passed and returned by value.
+ */
+#define OPTION_DEFINE(Type, Name)                                                                                      \
+    typedef struct {                                                                                                   \
+        Type __value;                                                                                                  \
+        bool __isSome;                                                                                                 \
+    } Name;                                                                                                            \
+                                                                                                                       \
+    __attribute__((__warn_unused_result__))                                                                            \
+    static inline Name Name##_some(Type value) {                                                                       \
+        return (Name) {.__value=value, .__isSome=true};                                                                \
+    }                                                                                                                  \
+                                                                                                                       \
+    __attribute__((__warn_unused_result__))                                                                            \
+    static inline Name Name##_none(void) {                                                                             \
+        return (Name) {.__isSome=false};                                                                               \
+    }                                                                                                                  \
+                                                                                                                       \
+    __attribute__((__warn_unused_result__))                                                                            \
+    static inline bool Name##_isSome(const Name self) {                                                                \
+        return self.__isSome;                                                                                          \
+    }                                                                                                                  \
+                                                                                                                       \
+    __attribute__((__warn_unused_result__))                                                                            \
+    static inline Name __##Name##_lift(Type value) {                                                                   \
+        return Name##_some(value);                                                                                     \
+    }                                                                                                                  \
+                                                                                                                       \
+    __OPTION_DEFINE_COMBINATORS(Type, Name)
+
+/**
+ * Defines a niche-encoded typed option named Name wrapping values of type Type.
+ * noneValue is the value used to represent `None` and isNone(value) the predicate that recognizes it.
+ *
+ * @attention isNone(noneValue) must be `true`; values for which isNone is `true` cannot be wrapped by `Name_some`.
+ */
+#define OPTION_DEFINE_NICHE(Type, Name, noneValue, isNone)                                                             \
+    typedef struct {                                                                                                   \
+        Type __value;                                                                                                  \
+    } Name;                                                                                                            \
+                                                                                                                       \
+    __attribute__((__warn_unused_result__))                                                                            \
+    static inline Name Name##_some(Type value) {                                                                       \
+        __Option_panicWhen(isNone(value));                                                                             \
+        return (Name) {.__value=value};                                                                                \
+    }                                                                                                                  \
+                                                                                                                       \
+    __attribute__((__warn_unused_result__))                                                                            \
+    static inline Name Name##_none(void) {                                                                             \
+        return (Name) {.__value=(noneValue)};                                                                          \
+    }                                                                                                                  \
+                                                                                                                       \
+    __attribute__((__warn_unused_result__))                                                                            \
+    static inline Name Name##_fromRaw(Type value) {                                                                    \
+        return (Name) {.__value=isNone(value) ? (noneValue) : value};                                                  \
+    }                                                                                                                  \
+                                                                                                                       \
+    __attribute__((__warn_unused_result__))                                                                            \
+    static inline bool Name##_isSome(const Name self) {                                                                \
+        return !isNone(self.__value);                                                                                  \
+    }                                                                                                                  \
+                                                                                                                       \
+    __attribute__((__warn_unused_result__))                                                                            \
+    static inline Name __##Name##_lift(Type value) {                                                                   \
+        return Name##_fromRaw(value);                                                                                  \
+    }                                                                                                                  \
+                                                                                                                       \
+    __OPTION_DEFINE_COMBINATORS(Type, Name)
+
+/**
+ * Defines a niche-encoded typed option named Name wrapping values of the scalar type Type,
+ * using sentinel (compared with `==`) to represent `None`.
+ */
+#define OPTION_DEFINE_SENTINEL(Type, Name, sentinel)                                                                   \
+    __attribute__((__warn_unused_result__))                                                                            \
+    static inline bool __##Name##_isSentinel(Type value) {                                                             \
+        return (sentinel) == value;                                                                                    \
+    }                                                                                                                  \
+                                                                                                                       \
+    OPTION_DEFINE_NICHE(Type, Name, (sentinel), __##Name##_isSentinel)
+
+/**
+ * Unwraps the value of a typed option named Name if it is wrapping a value else panics.
+ */
+#define OPTION_UNWRAP(Name, self) \
+    __##Name##_unwrap((__FILE__), (__LINE__), (self))
+
+/**
+ * Unwraps the value of a typed option named Name if it is wrapping a value else panics printing a custom message.
+ */
+#define OPTION_EXPECT(Name, self, ...) \
+    __##Name##_expect((__FILE__), (__LINE__), (self), __VA_ARGS__)
+
+/**
+ * @attention this macro must be treated as opaque therefore must not be used directly.
+ *
+ * Emits the combinators shared by every typed option, given `Name_some`, `Name_none`, `Name_isSome`
+ * and `__Name_lift` (which wraps the result of `Name_map` callbacks).
+ */
+#define __OPTION_DEFINE_COMBINATORS(Type, Name)                                                                        \
+    __attribute__((__warn_unused_result__))                                                                            \
+    static inline bool Name##_isNone(const Name self) {                                                                \
+        return !Name##_isSome(self);                                                                                   \
+    }                                                                                                                  \
+                                                                                                                       \
+    __attribute__((__warn_unused_result__))                                                                            \
+    static inline Name Name##_map(const Name self, Type (*const f)(Type)) {                                            \
+        __Option_panicWhen(NULL == f);                                                                                 \
+        return Name##_isNone(self) ? self : __##Name##_lift(f(self.__value));                                          \
+    }                                                                                                                  \
+                                                                                                                       \
+    __attribute__((__warn_unused_result__))                                                                            \
+    static inline Name Name##_chain(const Name self, Name (*const f)(Type)) {                                          \
+        __Option_panicWhen(NULL == f);                                                                                 \
+        return Name##_isNone(self) ? self : f(self.__value);                                                           \
+    }                                                                                                                  \
+                                                                                                                       \
+    __attribute__((__warn_unused_result__))                                                                            \
+    static inline Name Name##_alt(const Name self, const Name other) {                                                 \
+        return Name##_isSome(self) ? self : other;                                                                     \
+    }                                                                                                                  \
+                                                                                                                       \
+    __attribute__((__warn_unused_result__))                                                                            \
+    static inline Name Name##_orElse(const Name self, Name (*const f)(void)) {                                         \
+        __Option_panicWhen(NULL == f);                                                                                 \
+        return Name##_isSome(self) ? self : f();                                                                       \
+    }                                                                                                                  \
+                                                                                                                       \
+    __attribute__((__nonnull__(1)))                                                                                    \
+    static inline Type __##Name##_unwrap(const char *const file, const int line, const Name self) {                    \
+        if (__builtin_expect(Name##_isNone(self), 0)) {                                                                \
+            __Panic_terminate(file, line, "%s", "Unable to unwrap value");                                             \
+        }                                                                                                              \
+        return self.__value;                                                                                           \
+    }                                                                                                                  \
+                                                                                                                       \
+    __attribute__((__nonnull__(1, 4), __format__(__printf__, 4, 5)))                                                   \
+    static inline Type __##Name##_expect(const char *const file, const int line, const Name self,                      \
+                                         const char *const format, ...) {                                              \
+        if (__builtin_expect(Name##_isNone(self), 0)) {                                                                \
+            va_list args;                                                                                              \
+            va_start(args, format);                                                                                    \
+            __Panic_vterminate(file, line, format, args);                                                              \
+        }                                                                                                              \
+        return self.__value;                                                                                           \
+    }
+
+/**
+ * @attention this function must be treated as opaque therefore must not be called directly.
+ */
+__attribute__((__warn_unused_result__))
+static inline bool __Option_isNan(const double value) {
+    return value != value;
+}
+
+/**
+ * A niche-encoded `double` option: every NaN represents `None`.
+ */
+OPTION_DEFINE_NICHE(double, OptionF64, __builtin_nan(""), __Option_isNan)
+
+/**
+ * A niche-encoded `int64_t` option: `INT64_MIN` represents `None`.
+ */
+OPTION_DEFINE_SENTINEL(int64_t, OptionI64, INT64_MIN)
+
+/**
+ * A niche-encoded index option: `UINT32_MAX` represents `None`.
+ */
+OPTION_DEFINE_SENTINEL(uint32_t, OptionIndex, UINT32_MAX)
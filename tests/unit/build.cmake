@@ -1,8 +1,53 @@
-add_library(features ${CMAKE_CURRENT_LIST_DIR}/features.h ${CMAKE_CURRENT_LIST_DIR}/features.c)
-target_link_libraries(features PRIVATE option traits-unit)
+set(FEATURES_SOURCES
+        ${CMAKE_CURRENT_LIST_DIR}/features.h
+        ${CMAKE_CURRENT_LIST_DIR}/features.c
+        ${CMAKE_CURRENT_LIST_DIR}/features-typed-option.c
+        ${CMAKE_CURRENT_LIST_DIR}/features-option-batch.c
+        ${CMAKE_CURRENT_LIST_DIR}/features-option-vector.c
+        ${CMAKE_CURRENT_LIST_DIR}/features-option-pipeline.c
+        ${CMAKE_CURRENT_LIST_DIR}/features-option-arena.c
+        ${CMAKE_CURRENT_LIST_DIR}/features-option-slab.c
+        ${CMAKE_CURRENT_LIST_DIR}/features-option-iterator.c
+        ${CMAKE_CURRENT_LIST_DIR}/features-option-parallel.c
+        ${CMAKE_CURRENT_LIST_DIR}/features-option-promise.c
+        ${CMAKE_CURRENT_LIST_DIR}/features-option-atomic.c
+        ${CMAKE_CURRENT_LIST_DIR}/features-option-rcu.c
+        ${CMAKE_CURRENT_LIST_DIR}/features-option-once.c
+        ${CMAKE_CURRENT_LIST_DIR}/features-option-memo.c
+        ${CMAKE_CURRENT_LIST_DIR}/features-option-generic.c
+        ${CMAKE_CURRENT_LIST_DIR}/features-option-hpp.cpp
+        ${CMAKE_CURRENT_LIST_DIR}/features-panic.c)
+
+add_library(features ${FEATURES_SOURCES})
+target_link_libraries(features PRIVATE option panic traits-unit)
+
+add_library(features-fast ${FEATURES_SOURCES})
+target_link_libraries(features-fast PRIVATE option-fast panic traits-unit)
+
+add_library(features-call-sites ${FEATURES_SOURCES})
+target_compile_definitions(features-call-sites PRIVATE OPTION_CALL_SITES)
+target_link_libraries(features-call-sites PRIVATE option panic traits-unit)
+
+add_library(features-header-only ${FEATURES_SOURCES})
+target_link_libraries(features-header-only PRIVATE option-header-only option traits-unit)
+
+# option-generic.h requires C11
+set_target_properties(features features-fast features-call-sites features-header-only PROPERTIES C_STANDARD 11)
 
 add_executable(describe ${CMAKE_CURRENT_LIST_DIR}/describe.c)
 target_link_libraries(describe PRIVATE features)
 
+add_executable(describe-fast ${CMAKE_CURRENT_LIST_DIR}/describe.c)
+target_link_libraries(describe-fast PRIVATE features-fast)
+
+add_executable(describe-call-sites ${CMAKE_CURRENT_LIST_DIR}/describe.c)
+target_link_libraries(describe-call-sites PRIVATE features-call-sites)
+
+add_executable(describe-header-only ${CMAKE_CURRENT_LIST_DIR}/describe.c)
+target_link_libraries(describe-header-only PRIVATE features-header-only)
+
 add_test(describe describe)
+add_test(describe-fast describe-fast)
+add_test(describe-call-sites describe-call-sites)
+add_test(describe-header-only describe-header-only)
 enable_testing()
@@ -37,7 +37,100 @@ Describe("Option",
                Run(Option_chain),
                Run(Option_alt),
                Run(Option_orElse),
+               Run(Option_mapWith),
+               Run(Option_chainWith),
+               Run(Option_orElseWith),
                Run(Option_unwrap),
                Run(Option_unwrapAsMutable),
                Run(Option_expect),
-               Run(Option_expectAsMutable)))
+               Run(Option_expectAsMutable),
+               Run(Option_callSites)),
+         Trait("TypedOption",
+               Run(TypedOption_some),
+               Run(TypedOption_none),
+               Run(TypedOption_map),
+               Run(TypedOption_chain),
+               Run(TypedOption_alt),
+               Run(TypedOption_orElse),
+               Run(TypedOption_unwrap),
+               Run(TypedOption_expect)),
+         Trait("NicheOption",
+               Run(NicheOption_size),
+               Run(NicheOption_some),
+               Run(NicheOption_none),
+               Run(NicheOption_fromRaw),
+               Run(NicheOption_map)),
+         Trait("OptionBatch",
+               Run(OptionBatch_kernels),
+               Run(OptionBatch_countSome),
+               Run(OptionBatch_findNone),
+               Run(OptionBatch_maskSome),
+               Run(OptionBatch_compactSome)),
+         Trait("OptionVector",
+               Run(OptionVector_new),
+               Run(OptionVector_fromArray),
+               Run(OptionVector_set),
+               Run(OptionVector_map),
+               Run(OptionVector_filter),
+               Run(OptionVector_alt)),
+         Trait("OptionPipeline",
+               Run(OptionPipeline_new),
+               Run(OptionPipeline_run),
+               Run(OptionPipeline_runAll),
+               Run(OptionPipeline_noneCount)),
+         Trait("OptionArena",
+               Run(OptionArena_alloc),
+               Run(OptionArena_rewind),
+               Run(OptionArena_thread),
+               Run(OptionArena_map),
+               Run(OptionArena_chain)),
+         Trait("OptionSlab",
+               Run(OptionSlab_alloc),
+               Run(OptionSlab_free),
+               Run(OptionSlab_threads)),
+         Trait("OptionIterator",
+               Run(OptionIterator_new),
+               Run(OptionIterator_adaptors),
+               Run(OptionIterator_takeSkip),
+               Run(OptionIterator_zip),
+               Run(OptionIterator_fused)),
+         Trait("OptionParallel",
+               Run(OptionPool_new),
+               Run(Option_parallelMap),
+               Run(Option_parallelChain)),
+         Trait("OptionPromise",
+               Run(OptionPromise_fulfill),
+               Run(OptionPromise_wait),
+               Run(OptionPromise_then)),
+         Trait("AtomicOption",
+               Run(AtomicOption_operations),
+               Run(AtomicOption_threads),
+               Run(OptionHazard_retire)),
+         Trait("OptionRcu",
+               Run(OptionRcu_publish),
+               Run(OptionRcu_threads)),
+         Trait("OptionOnce",
+               Run(OptionOnce_get),
+               Run(OptionOnce_threads)),
+         Trait("OptionMemo",
+               Run(OptionMemo_call),
+               Run(OptionMemo_evict),
+               Run(OptionMemo_keys)),
+         Trait("OptionGeneric",
+               Run(OptionGeneric_map),
+               Run(OptionGeneric_chain)),
+         Trait("OptionHpp",
+               Run(OptionHpp_some),
+               Run(OptionHpp_niche),
+               Run(OptionHpp_combinators),
+               Run(OptionHpp_interop)),
+         Trait("Panic",
+               Run(Panic_registerCallback),
+               Run(Panic_registerHook),
+               Run(Panic_unregisterHook),
+               Run(Panic_setReportSink),
+               Run(Panic_openReportSink),
+               Run(Panic_formatIntegers),
+               Run(Panic_formatDoubles),
+               Run(Panic_formatStrings),
+               Run(Panic_formatTruncation)))
@@ -0,0 +1,137 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <option-arena.h>
+#include <traits/traits.h>
+#include "features.h"
+
+static bool arenaSquare(void *result, const void *value) {
+    const int number = *(const int *) value;
+    *(int *) result = number * number;
+    return number < 100;
+}
+
+static Option arenaPair(OptionArena *arena, const void *value) {
+    int *pair = OptionArena_alloc(arena, 2 * sizeof(*pair), __alignof__(int));
+    pair[0] = pair[1] = *(const int *) value;
+    return pair[0] % 2 ? None : Option_some(pair);
+}
+
+static void *arenaOfThread(void *_) {
+    (void) _;
+    return OptionArena_thread();
+}
+
+Feature(OptionArena_alloc) {
+    OptionArena *sut = OptionArena_new(64);
+    assert_equal(OptionArena_used(sut), 0);
+
+    char *bytes = OptionArena_alloc(sut, 3, 1);
+    memset(bytes, 'x', 3);
+    double *aligned = OptionArena_alloc(sut, sizeof(*aligned), __alignof__(double));
+    assert_equal((uintptr_t) aligned % __alignof__(double), 0);
+    *aligned = 1.5;
+
+    // larger than a chunk
+    char *large = OptionArena_alloc(sut, 1000, 16);
+    assert_equal((uintptr_t) large % 16, 0);
+    memset(large, 'y', 1000);
+    assert_equal(*aligned, 1.5);
+    assert_greater_equal(OptionArena_used(sut), 1000 + 3 + sizeof(double));
+    OptionArena_delete(sut);
+
+#if !defined(OPTION_UNCHECKED)
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+    traits_unit_wraps(SIGABRT) {
+        void *_ = OptionArena_alloc(OptionArena_new(0), 8, 3);
+        (void) _;
+    }
+    assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 1);
+#endif
+}
+
+Feature(OptionArena_rewind) {
+    OptionArena *sut = OptionArena_new(64);
+    int *first = OptionArena_alloc(sut, sizeof(*first), __alignof__(int));
+    const OptionArenaMark mark = OptionArena_mark(sut);
+    const size_t used = OptionArena_used(sut);
+
+    for (size_t i = 0; i < 100; i++) {
+        int *_ = OptionArena_alloc(sut, sizeof(*_), __alignof__(int));
+        (void) _;
+    }
+    OptionArena_rewind(sut, mark);
+    assert_equal(OptionArena_used(sut), used);
+    int *second = OptionArena_alloc(sut, sizeof(*second), __alignof__(int));
+    assert_equal(second, first + 1);
+
+    OptionArena_reset(sut);
+    assert_equal(OptionArena_used(sut), 0);
+    assert_equal(OptionArena_alloc(sut, sizeof(int), __alignof__(int)), first);
+    OptionArena_delete(sut);
+}
+
+Feature(OptionArena_thread) {
+    OptionArena *sut = OptionArena_thread();
+    assert_equal(OptionArena_thread(), sut);
+
+    pthread_t thread;
+    void *other = NULL;
+    assert_equal(pthread_create(&thread, NULL, arenaOfThread, NULL), 0);
+    assert_equal(pthread_join(thread, &other), 0);
+    assert_not_null(other);
+    assert_not_equal(other, sut);
+}
+
+Feature(OptionArena_map) {
+    OptionArena *sut = OptionArena_new(0);
+    static const int values[2] = {7, 100};
+
+    assert_equal(*(const int *) Option_unwrap(OptionArena_map(sut, Option_some(values), sizeof(int), arenaSquare)), 49);
+    const size_t used = OptionArena_used(sut);
+    assert_true(Option_isNone(OptionArena_map(sut, Option_some(values + 1), sizeof(int), arenaSquare)));
+    assert_equal(OptionArena_used(sut), used);
+    assert_true(Option_isNone(OptionArena_map(sut, None, sizeof(int), arenaSquare)));
+    assert_equal(OptionArena_used(sut), used);
+    OptionArena_delete(sut);
+}
+
+Feature(OptionArena_chain) {
+    OptionArena *sut = OptionArena_new(0);
+    static const int values[2] = {2, 3};
+
+    const int *pair = Option_unwrap(OptionArena_chain(sut, Option_some(values), arenaPair));
+    assert_equal(pair[0], 2);
+    assert_equal(pair[1], 2);
+    const size_t used = OptionArena_used(sut);
+    assert_true(Option_isNone(OptionArena_chain(sut, Option_some(values + 1), arenaPair)));
+    assert_equal(OptionArena_used(sut), used);
+    OptionArena_delete(sut);
+}
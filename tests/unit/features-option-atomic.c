@@ -0,0 +1,127 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <sched.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <option-atomic.h>
+#include <traits/traits.h>
+#include "features.h"
+
+#define ATOMIC_ITEMS    10000
+
+static size_t atomicReclaimed = 0;
+
+static void atomicReclaim(void *value) {
+    atomicReclaimed++;
+    free(value);
+}
+
+static void *atomicProducer(void *slot) {
+    for (size_t i = 0; i < ATOMIC_ITEMS; i++) {
+        const Option item = Option_some(digits + i % 10);
+        while (!AtomicOption_putIfNone(slot, item, OptionMemoryOrder_release)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+Feature(AtomicOption_operations) {
+    AtomicOption sut = ATOMIC_OPTION_INIT;
+    assert_true(Option_isNone(AtomicOption_load(&sut, OptionMemoryOrder_acquire)));
+    assert_true(AtomicOption_putIfNone(&sut, Option_some(digits + 1), OptionMemoryOrder_release));
+    assert_false(AtomicOption_putIfNone(&sut, Option_some(digits + 2), OptionMemoryOrder_release));
+    assert_equal(AtomicOption_load(&sut, OptionMemoryOrder_relaxed).__value, digits + 1);
+
+    assert_equal(AtomicOption_replace(&sut, Option_some(digits + 3), OptionMemoryOrder_acqRel).__value,
+                 digits + 1);
+    Option expected = Option_some(digits + 1);
+    assert_false(AtomicOption_compareExchange(&sut, &expected, None,
+                                              OptionMemoryOrder_acqRel, OptionMemoryOrder_acquire));
+    assert_equal(expected.__value, digits + 3);
+    assert_true(AtomicOption_compareExchange(&sut, &expected, Option_some(digits + 4),
+                                             OptionMemoryOrder_seqCst, OptionMemoryOrder_seqCst));
+
+    assert_equal(AtomicOption_take(&sut, OptionMemoryOrder_acquire).__value, digits + 4);
+    assert_true(Option_isNone(AtomicOption_take(&sut, OptionMemoryOrder_acquire)));
+    AtomicOption_store(&sut, Option_some(digits + 5), OptionMemoryOrder_release);
+    assert_equal(AtomicOption_load(&sut, OptionMemoryOrder_seqCst).__value, digits + 5);
+}
+
+Feature(AtomicOption_threads) {
+    AtomicOption sut = ATOMIC_OPTION_INIT;
+    pthread_t producer;
+    assert_equal(pthread_create(&producer, NULL, atomicProducer, &sut), 0);
+    size_t received = 0, sum = 0;
+    while (received < ATOMIC_ITEMS) {
+        const Option item = AtomicOption_take(&sut, OptionMemoryOrder_acquire);
+        if (Option_isSome(item)) {
+            sum += (size_t) *(const int *) item.__value;
+            received++;
+        } else {
+            sched_yield();
+        }
+    }
+    assert_equal(pthread_join(producer, NULL), 0);
+    assert_equal(sum, (size_t) ATOMIC_ITEMS / 10 * 45);
+    assert_true(Option_isNone(AtomicOption_load(&sut, OptionMemoryOrder_relaxed)));
+}
+
+Feature(OptionHazard_retire) {
+    AtomicOption sut = ATOMIC_OPTION_INIT;
+    AtomicOption_store(&sut, Option_some(calloc(1, sizeof(int))), OptionMemoryOrder_release);
+    OptionHazard *hazard = OptionHazard_acquire();
+    const Option protected = AtomicOption_protect(&sut, hazard);
+
+    // unlinked but still protected: not reclaimed
+    const Option old = AtomicOption_replace(&sut, Option_some(calloc(1, sizeof(int))), OptionMemoryOrder_acqRel);
+    assert_equal(old.__value, protected.__value);
+    atomicReclaimed = 0;
+    OptionHazard_retire((void *) old.__value, atomicReclaim);
+    assert_equal(OptionHazard_scan(), 1);
+    assert_equal(atomicReclaimed, 0);
+
+    OptionHazard_clear(hazard);
+    assert_equal(OptionHazard_scan(), 0);
+    assert_equal(atomicReclaimed, 1);
+
+    // retiring more values than the per-thread buffer holds scans it in between
+    atomicReclaimed = 0;
+    for (size_t i = 0; i < 1000; i++) {
+        OptionHazard_retire(calloc(1, sizeof(int)), atomicReclaim);
+    }
+    assert_greater_equal(atomicReclaimed, 1000 - 128);
+    assert_equal(OptionHazard_scan(), 0);
+    assert_equal(atomicReclaimed, 1000);
+
+    // released hazards are reused
+    OptionHazard_release(hazard);
+    assert_equal(OptionHazard_acquire(), hazard);
+    OptionHazard_release(hazard);
+    free((void *) AtomicOption_take(&sut, OptionMemoryOrder_acquire).__value);
+}
@@ -0,0 +1,153 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <option-batch.h>
+#include <traits/traits.h>
+#include "features.h"
+
+// covers 0 to 4 steps of every vector width (8, 16 and 32 items), each followed by every possible tail
+#define ITEMS_LENGTH    131
+
+static const char value[] = "A";
+
+static const char *const kernelsNames[] = {"scalar", "sse2", "avx2", "avx512"};
+
+/*
+ * Forces the next kernels supported by the CPU starting from *index, restores the runtime selection when done.
+ */
+static bool forceNextKernels(size_t *const index) {
+    for (; *index < sizeof(kernelsNames) / sizeof(kernelsNames[0]); (*index)++) {
+        if (__Option_forceBatchKernels(kernelsNames[*index])) {
+            assert_string_equal(Option_batchKernels(), kernelsNames[*index]);
+            (*index)++;
+            return true;
+        }
+    }
+    assert_true(__Option_forceBatchKernels(NULL));
+    return false;
+}
+
+/*
+ * Fills items with a pattern where every item whose index is a multiple of stride is `None`.
+ */
+static void fillItems(Option *const items, const size_t length, const size_t stride) {
+    for (size_t i = 0; i < length; i++) {
+        items[i] = (0 == i % stride) ? None : Option_some(value + (i % 2));
+    }
+}
+
+Feature(OptionBatch_kernels) {
+    const char *const selected = Option_batchKernels();
+    assert_false(__Option_forceBatchKernels("unknown"));
+    assert_string_equal(Option_batchKernels(), selected);
+    assert_true(__Option_forceBatchKernels("scalar"));
+    assert_string_equal(Option_batchKernels(), "scalar");
+    assert_true(__Option_forceBatchKernels(selected));
+    assert_string_equal(Option_batchKernels(), selected);
+    assert_true(__Option_forceBatchKernels(NULL));
+    assert_string_equal(Option_batchKernels(), selected);
+}
+
+Feature(OptionBatch_countSome) {
+    Option items[ITEMS_LENGTH];
+    assert_equal(Option_countSome(NULL, 0), 0);
+
+    for (size_t k = 0; forceNextKernels(&k);) {
+        for (size_t stride = 1; stride < 70; stride++) {
+            for (size_t length = 0; length <= ITEMS_LENGTH; length++) {
+                size_t expected = 0;
+                fillItems(items, length, stride);
+                for (size_t i = 0; i < length; i++) {
+                    expected += Option_isSome(items[i]);
+                }
+                assert_equal(Option_countSome(items, length), expected);
+            }
+        }
+    }
+}
+
+Feature(OptionBatch_findNone) {
+    Option items[ITEMS_LENGTH];
+    assert_equal(Option_findNone(NULL, 0), 0);
+
+    for (size_t k = 0; forceNextKernels(&k);) {
+        for (size_t length = 0; length <= ITEMS_LENGTH; length++) {
+            for (size_t i = 0; i < length; i++) {
+                items[i] = Option_some(value);
+            }
+            assert_equal(Option_findNone(items, length), length);
+            for (size_t none = 0; none < length; none++) {
+                items[none] = None;
+                assert_equal(Option_findNone(items, length), none);
+                items[none] = Option_some(value);
+            }
+        }
+    }
+}
+
+Feature(OptionBatch_maskSome) {
+    Option items[ITEMS_LENGTH];
+    uint64_t mask[(ITEMS_LENGTH + 63) / 64];
+
+    for (size_t k = 0; forceNextKernels(&k);) {
+        for (size_t stride = 1; stride < 70; stride++) {
+            for (size_t length = 0; length <= ITEMS_LENGTH; length++) {
+                fillItems(items, length, stride);
+                memset(mask, 0xFF, sizeof(mask));
+                Option_maskSome(items, length, mask);
+                for (size_t i = 0; i < length; i++) {
+                    assert_equal((mask[i / 64] >> (i % 64)) & 1, (uint64_t) Option_isSome(items[i]));
+                }
+                if (0 != length % 64) {
+                    assert_equal(mask[length / 64] >> (length % 64), 0);
+                }
+            }
+        }
+    }
+}
+
+Feature(OptionBatch_compactSome) {
+    Option items[ITEMS_LENGTH];
+    const void *values[ITEMS_LENGTH];
+
+    for (size_t k = 0; forceNextKernels(&k);) {
+        for (size_t stride = 1; stride < 70; stride++) {
+            for (size_t length = 0; length <= ITEMS_LENGTH; length++) {
+                fillItems(items, length, stride);
+                const size_t count = Option_compactSome(items, length, values);
+                size_t expected = 0;
+                for (size_t i = 0; i < length; i++) {
+                    if (Option_isSome(items[i])) {
+                        assert_equal(values[expected], Option_unwrap(items[i]));
+                        expected++;
+                    }
+                }
+                assert_equal(count, expected);
+            }
+        }
+    }
+}
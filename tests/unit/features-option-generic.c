@@ -0,0 +1,81 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <traits/traits.h>
+#include "features.h"
+
+struct GenericPoint {
+    int x;
+    int y;
+};
+
+#define OPTION_GENERIC_USER_TYPES(X) \
+    X(struct GenericPoint, GenericPoint)
+
+#include <option-generic.h>
+
+static const struct GenericPoint genericOrigin = {.x=0, .y=0};
+
+static const int *genericNext(const int *digit) {
+    return digit < digits + 9 ? digit + 1 : NULL;
+}
+
+static Option genericEven(const int *digit) {
+    return *digit % 2 ? None : Option_some(digit);
+}
+
+static const struct GenericPoint *genericOriginOf(const struct GenericPoint *point) {
+    return point->x || point->y ? &genericOrigin : NULL;
+}
+
+static const void *genericUntyped(const void *value) {
+    return value;
+}
+
+Feature(OptionGeneric_map) {
+    assert_equal(Option_unwrap(Option_map(Option_some(digits), genericNext)), digits + 1);
+    assert_true(Option_isNone(Option_map(Option_some(digits + 9), genericNext)));
+    assert_true(Option_isNone(Option_map(None, genericNext)));
+
+    const struct GenericPoint point = {.x=1, .y=2};
+    assert_equal(Option_unwrap(Option_map(Option_some(&point), genericOriginOf)), &genericOrigin);
+    assert_true(Option_isNone(Option_map(Option_some(&genericOrigin), genericOriginOf)));
+
+    // unregistered callbacks fall back to the generic implementation
+    assert_equal(Option_unwrap(Option_map(Option_some(digits), genericUntyped)), digits);
+}
+
+Feature(OptionGeneric_chain) {
+    assert_equal(Option_unwrap(Option_chain(Option_some(digits + 4), genericEven)), digits + 4);
+    assert_true(Option_isNone(Option_chain(Option_some(digits + 3), genericEven)));
+    assert_true(Option_isNone(Option_chain(None, genericEven)));
+
+    const Option sut = Option_chain(Option_map(Option_some(digits), genericNext), genericEven);
+    assert_true(Option_isNone(sut));
+    const Option twice = Option_map(Option_map(Option_some(digits), genericNext), genericNext);
+    assert_equal(Option_unwrap(Option_chain(twice, genericEven)), digits + 2);
+}
@@ -0,0 +1,138 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <memory>
+#include <string>
+#include <option.hpp>
+#include <traits/traits.h>
+#include "features.h"
+
+static_assert(sizeof(option::Option<const int *>) == sizeof(const int *));
+static_assert(std::is_trivially_copyable_v<option::Option<double>>);
+static_assert(std::is_copy_constructible_v<option::Option<std::string>>);
+static_assert(std::is_copy_assignable_v<option::Option<std::string>>);
+static_assert(!std::is_copy_constructible_v<option::Option<std::unique_ptr<int>>>);
+static_assert(!std::is_copy_assignable_v<option::Option<std::unique_ptr<int>>>);
+static_assert(std::is_nothrow_move_constructible_v<option::Option<std::unique_ptr<int>>>);
+static_assert(std::is_nothrow_move_assignable_v<option::Option<std::unique_ptr<int>>>);
+
+struct HppPinned {
+    HppPinned() = default;
+    HppPinned(const HppPinned &) = delete;
+    HppPinned &operator=(const HppPinned &) = delete;
+    ~HppPinned() {}
+};
+
+static_assert(!std::is_copy_constructible_v<option::Option<HppPinned>>);
+static_assert(!std::is_move_constructible_v<option::Option<HppPinned>>);
+static_assert(sizeof(option::Option<std::string>) == sizeof(option::__detail::Storage<std::string>));
+static_assert(option::some(20).map([](int x) { return x + 1; }).map([](int x) { return 2 * x; }).unwrap() == 42);
+static_assert(option::Option<int>().alt(option::some(7)).unwrap() == 7);
+
+static int hppPanicLine = 0;
+static const char *hppPanicFile = "";
+
+static option::Option<int> hppHalf(const int value) {
+    return value % 2 ? option::Option<int>() : option::some(value / 2);
+}
+
+Feature(OptionHpp_some) {
+    option::Option<int> sut = option::some(42);
+    assert_true(sut.isSome());
+    assert_false(sut.isNone());
+    assert_equal(sut.unwrap(), 42);
+    assert_true(option::Option<int>(option::none).isNone());
+
+    option::Option<std::unique_ptr<int>> unique = option::some(std::make_unique<int>(42));
+    std::unique_ptr<int> moved = std::move(unique).unwrap();
+    assert_equal(*moved, 42);
+
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+    traits_unit_wraps(SIGABRT) {
+        const int _ = option::Option<int>().unwrap();
+        (void) _;
+    }
+    assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 1);
+}
+
+Feature(OptionHpp_niche) {
+    assert_true(option::fromNullable(static_cast<const int *>(nullptr)).isNone());
+    assert_equal(option::fromNullable(digits).unwrap(), digits);
+    // mapping to nullptr is None, like Option_map
+    auto sut = option::some(digits + 1).map([](const int *digit) { return 1 == *digit ? nullptr : digit; });
+    assert_true(sut.isNone());
+
+    // the panic report locates the caller of some, not option.hpp
+    const auto hook = [](const Panic_Report *report, void *) {
+        hppPanicLine = report->line;
+        hppPanicFile = report->file;
+    };
+    assert_true(Panic_registerHook(hook, nullptr, 0));
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+    volatile int line = 0;
+    traits_unit_wraps(SIGABRT) {
+        line = __LINE__, option::some(static_cast<const int *>(nullptr));
+    }
+    assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 1);
+    assert_true(Panic_unregisterHook(hook, nullptr));
+    assert_equal(hppPanicLine, line);
+    assert_string_equal(hppPanicFile, __FILE__);
+}
+
+Feature(OptionHpp_combinators) {
+    assert_equal(option::some(4).chain(hppHalf).chain(hppHalf).unwrap(), 1);
+    assert_true(option::some(2).chain(hppHalf).chain(hppHalf).isNone());
+    assert_equal(option::some(std::string("A")).map([](const std::string &s) { return s + "B"; }).unwrap(), "AB");
+    assert_equal(option::Option<int>().orElse([] { return option::some(3); }).unwrap(), 3);
+    assert_equal(option::some(1).orElse([] { return option::some(3); }).unwrap(), 1);
+    assert_equal(option::Option<int>().unwrapOr(5), 5);
+    assert_true(option::some(1) == option::some(1));
+    assert_true(option::some(1) != option::Option<int>());
+}
+
+Feature(OptionHpp_interop) {
+    const option::Option<const int *> fromC(Option_some(digits));
+    assert_equal(fromC.unwrap(), digits);
+    assert_true(option::Option<const int *>(None).isNone());
+    assert_equal(Option_unwrap(fromC.toC()), digits);
+    assert_true(Option_isNone(option::Option<const int *>().toC()));
+
+    const option::Option<int> value = option::some(42);
+    assert_equal(*static_cast<const int *>(Option_unwrap(value.borrow())), 42);
+    assert_true(Option_isNone(option::Option<int>().borrow()));
+
+    const option::Option<std::string> fromStd = std::optional<std::string>("A");
+    assert_equal(fromStd.unwrap(), "A");
+    assert_true(option::Option<int>(std::optional<int>()).isNone());
+    assert_equal(fromStd.toStd(), std::optional<std::string>("A"));
+    assert_false(option::Option<int>().toStd().has_value());
+
+    // pointers round trip lossily: an engaged std::optional holding nullptr becomes None
+    const option::Option<const int *> fromNullptr = std::optional<const int *>(nullptr);
+    assert_true(fromNullptr.isNone());
+    assert_false(fromNullptr.toStd().has_value());
+}
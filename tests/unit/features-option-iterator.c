@@ -0,0 +1,168 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <option-iterator.h>
+#include <traits/traits.h>
+#include "features.h"
+
+static Option iteratorCountdown(void *context) {
+    int *counter = context;
+    return 0 == *counter ? None : Option_some(digits + --*counter);
+}
+
+static bool iteratorIsEven(const void *value) {
+    return 0 == *(const int *) value % 2;
+}
+
+static const void *iteratorNext(const void *value) {
+    return (const int *) value + 1;
+}
+
+static Option iteratorHalf(const void *value) {
+    const int digit = *(const int *) value;
+    return digit % 2 ? None : Option_some(digits + digit / 2);
+}
+
+static const void *iteratorSum(const void *accumulator, const void *value) {
+    return (const void *) ((uintptr_t) accumulator + (uintptr_t) *(const int *) value);
+}
+
+static const void *iteratorSecond(const void *first, const void *second) {
+    (void) first;
+    return second;
+}
+
+Feature(OptionIterator_new) {
+    int counter = 3;
+    OptionIterator sut;
+    OptionIterator_new(&sut, iteratorCountdown, &counter);
+    assert_equal(Option_unwrap(OptionIterator_next(&sut)), digits + 2);
+    assert_equal(Option_unwrap(OptionIterator_next(&sut)), digits + 1);
+    assert_equal(Option_unwrap(OptionIterator_next(&sut)), digits);
+    assert_true(Option_isNone(OptionIterator_next(&sut)));
+
+    OptionIterator_fromArray(&sut, digits, 10, sizeof(digits[0]));
+    assert_equal(Option_unwrap(OptionIterator_next(&sut)), digits);
+    assert_equal(OptionIterator_count(&sut), 9);
+    assert_true(Option_isNone(OptionIterator_next(&sut)));
+    assert_equal(OptionIterator_count(OptionIterator_fromArray(&sut, NULL, 0, sizeof(int))), 0);
+}
+
+Feature(OptionIterator_adaptors) {
+    OptionIterator source, evens, nexts, halves;
+    OptionIterator_fromArray(&source, digits, 10, sizeof(digits[0]));
+    OptionIterator_filter(&evens, &source, iteratorIsEven);
+    OptionIterator_map(&nexts, &evens, iteratorNext);
+    // 1 3 5 7 9
+    assert_equal(OptionIterator_fold(&nexts, NULL, iteratorSum), (const void *) 25);
+
+    OptionIterator_fromArray(&source, digits, 10, sizeof(digits[0]));
+    OptionIterator_filterMap(&halves, &source, iteratorHalf);
+    // 0 1 2 3 4
+    assert_equal(OptionIterator_fold(&halves, NULL, iteratorSum), (const void *) 10);
+}
+
+Feature(OptionIterator_takeSkip) {
+    OptionIterator source, skipped, taken;
+    OptionIterator_fromArray(&source, digits, 10, sizeof(digits[0]));
+    OptionIterator_skip(&skipped, &source, 3);
+    OptionIterator_take(&taken, &skipped, 4);
+    assert_equal(Option_unwrap(OptionIterator_next(&taken)), digits + 3);
+    // 4 5 6
+    assert_equal(OptionIterator_fold(&taken, NULL, iteratorSum), (const void *) 15);
+    assert_true(Option_isNone(OptionIterator_next(&taken)));
+
+    OptionIterator_fromArray(&source, digits, 10, sizeof(digits[0]));
+    assert_equal(OptionIterator_count(OptionIterator_skip(&skipped, &source, 20)), 0);
+}
+
+Feature(OptionIterator_zip) {
+    OptionIterator first, second, zipped;
+    OptionIterator_fromArray(&first, digits, 3, sizeof(digits[0]));
+    OptionIterator_fromArray(&second, digits + 5, 5, sizeof(digits[0]));
+    OptionIterator_zip(&zipped, &first, &second, iteratorSecond);
+    // 5 6 7, the shortest iterator wins
+    assert_equal(OptionIterator_fold(&zipped, NULL, iteratorSum), (const void *) 18);
+}
+
+Feature(OptionIterator_fused) {
+    size_t expected = 0, seen = 0;
+    for (size_t i = 0; i < 10; i++) {
+        if (iteratorIsEven(digits + i) && 2 <= seen++ && seen <= 5) {
+            expected += (size_t) *(const int *) iteratorNext(digits + i);
+        }
+    }
+
+    // 4 6 8 mapped to 5 7 9, as the hand-written loop above
+    size_t total = 0, skipped = 2, remaining = 3;
+    OptionIterator_forArray(value, digits, 10, sizeof(digits[0]))
+        OptionIterator_forFilter(value, iteratorIsEven)
+            OptionIterator_forSkip(skipped)
+                OptionIterator_forMap(value, iteratorNext)
+                    OptionIterator_forTake(remaining) {
+                        total += (size_t) *(const int *) value;
+                    }
+    assert_equal(total, expected);
+    assert_equal(total, 21);
+    assert_equal(skipped, 0);
+    assert_equal(remaining, 0);
+
+    // the runtime chains yield the same values
+    OptionIterator source, evens, skippedEvens, nexts, taken;
+    OptionIterator_fromArray(&source, digits, 10, sizeof(digits[0]));
+    OptionIterator_filter(&evens, &source, iteratorIsEven);
+    OptionIterator_skip(&skippedEvens, &evens, 2);
+    OptionIterator_map(&nexts, &skippedEvens, iteratorNext);
+    OptionIterator_take(&taken, &nexts, 3);
+    assert_equal(OptionIterator_fold(&taken, NULL, iteratorSum), (const void *) 21);
+
+    // a runtime iterator as source, filterMap drops None, break ends the pipeline
+    int counter = 10;
+    total = 0;
+    OptionIterator_new(&source, iteratorCountdown, &counter);
+    OptionIterator_forEach(value, &source)
+        OptionIterator_forFilterMap(value, iteratorHalf) {
+            if (0 == *(const int *) value) {
+                break;
+            }
+            total += (size_t) *(const int *) value;
+        }
+    // 9..0 halved where even: 4 3 2 1, then 0 breaks
+    assert_equal(total, 10);
+    assert_equal(counter, 0);
+
+    // take stops pulling from the source as soon as it is done
+    counter = 10;
+    remaining = 2;
+    OptionIterator_new(&source, iteratorCountdown, &counter);
+    OptionIterator_forEach(value, &source)
+        OptionIterator_forTake(remaining) {
+            (void) value;
+        }
+    assert_equal(counter, 8);
+}
@@ -0,0 +1,150 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <time.h>
+#include <stdint.h>
+#include <string.h>
+#include <option-memo.h>
+#include <traits/traits.h>
+#include "features.h"
+
+static size_t memoCalls = 0;
+
+static Option memoEven(const void *value) {
+    const int *digit = value;
+    memoCalls++;
+    return *digit % 2 ? None : Option_some(digit);
+}
+
+static Option memoLength(const void *value) {
+    memoCalls++;
+    return Option_some(digits + strlen(value) % 10);
+}
+
+static size_t memoHash(const void *key) {
+    size_t hash = 5381;
+    for (const char *c = key; '\0' != *c; c++) {
+        hash = hash * 33 + (unsigned char) *c;
+    }
+    return hash;
+}
+
+static bool memoEqual(const void *first, const void *second) {
+    return 0 == strcmp(first, second);
+}
+
+Feature(OptionMemo_call) {
+    OptionMemo *sut = OptionMemo_new(memoEven, 8, NULL, NULL, 0);
+    memoCalls = 0;
+    assert_equal(OptionMemo_call(sut, digits + 4).__value, digits + 4);
+    assert_equal(OptionMemo_call(sut, digits + 4).__value, digits + 4);
+    // None results are cached too
+    assert_true(Option_isNone(OptionMemo_call(sut, digits + 3)));
+    assert_true(Option_isNone(Option_chainWith(Option_some(digits + 3), OptionMemo_call, sut)));
+    assert_equal(Option_chainWith(Option_some(digits + 4), OptionMemo_call, sut).__value, digits + 4);
+    assert_equal(memoCalls, 2);
+
+    OptionMemoStats stats = OptionMemo_stats(sut);
+    assert_equal(stats.hits, 3);
+    assert_equal(stats.misses, 2);
+    assert_equal(stats.evictions, 0);
+    assert_equal(stats.size, 2);
+
+    OptionMemo_clear(sut);
+    assert_equal(OptionMemo_stats(sut).size, 0);
+    assert_equal(OptionMemo_call(sut, digits + 4).__value, digits + 4);
+    assert_equal(memoCalls, 3);
+    OptionMemo_delete(sut);
+
+    // overflows are not caller contracts: they panic even when contracts are unchecked
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+    traits_unit_wraps(SIGABRT) {
+        OptionMemo *_ = OptionMemo_new(memoEven, SIZE_MAX, NULL, NULL, 0);
+        (void) _;
+    }
+    traits_unit_wraps(SIGABRT) {
+        OptionMemo *_ = OptionMemo_new(memoEven, SIZE_MAX / 2 / sizeof(size_t) + 1, NULL, NULL, 0);
+        (void) _;
+    }
+    assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 2);
+}
+
+Feature(OptionMemo_evict) {
+    OptionMemo *sut = OptionMemo_new(memoEven, 2, NULL, NULL, 0);
+    memoCalls = 0;
+    Option _;
+    _ = OptionMemo_call(sut, digits + 0);
+    _ = OptionMemo_call(sut, digits + 1);
+    _ = OptionMemo_call(sut, digits + 0);
+
+    // 0 was referenced since it was cached: 1 is evicted in its place
+    _ = OptionMemo_call(sut, digits + 2);
+    assert_equal(OptionMemo_stats(sut).evictions, 1);
+    _ = OptionMemo_call(sut, digits + 0);
+    assert_equal(memoCalls, 3);
+    _ = OptionMemo_call(sut, digits + 1);
+    assert_equal(memoCalls, 4);
+    (void) _;
+
+    const OptionMemoStats stats = OptionMemo_stats(sut);
+    assert_equal(stats.evictions, 2);
+    assert_equal(stats.size, 2);
+    OptionMemo_delete(sut);
+}
+
+Feature(OptionMemo_keys) {
+    OptionMemo *sut = OptionMemo_new(memoLength, 4, memoHash, memoEqual, 0);
+    char first[] = "option", second[] = "option";
+    memoCalls = 0;
+    assert_equal(OptionMemo_call(sut, first).__value, digits + 6);
+    assert_equal(OptionMemo_call(sut, second).__value, digits + 6);
+    assert_equal(OptionMemo_call(sut, "none").__value, digits + 4);
+    assert_equal(memoCalls, 2);
+    OptionMemo_delete(sut);
+
+    // entries expire after their time-to-live, 50ms leave room for a slow or preempted test run
+    sut = OptionMemo_new(memoEven, 2, NULL, NULL, 50000000);
+    assert_equal(OptionMemo_call(sut, digits + 8).__value, digits + 8);
+    assert_equal(OptionMemo_call(sut, digits + 8).__value, digits + 8);
+    nanosleep(&(struct timespec) {.tv_sec=0, .tv_nsec=60000000}, NULL);
+    assert_equal(OptionMemo_call(sut, digits + 8).__value, digits + 8);
+    OptionMemoStats stats = OptionMemo_stats(sut);
+    assert_equal(stats.hits, 1);
+    assert_equal(stats.misses, 2);
+    assert_equal(stats.size, 1);
+    assert_equal(memoCalls, 4);
+
+    // the refreshed entry kept its CLOCK bit, so the hand evicts the unreferenced one
+    assert_equal(OptionMemo_call(sut, digits + 6).__value, digits + 6);
+    assert_equal(OptionMemo_call(sut, digits + 4).__value, digits + 4);
+    assert_equal(OptionMemo_call(sut, digits + 8).__value, digits + 8);
+    stats = OptionMemo_stats(sut);
+    assert_equal(stats.hits, 2);
+    assert_equal(stats.evictions, 1);
+    assert_equal(memoCalls, 6);
+    OptionMemo_delete(sut);
+}
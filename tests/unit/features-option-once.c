@@ -0,0 +1,95 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <sched.h>
+#include <pthread.h>
+#include <option-once.h>
+#include <traits/traits.h>
+#include "features.h"
+
+#define ONCE_THREADS    8
+
+static size_t onceCalls = 0;
+static OptionOnce onceShared = OPTION_ONCE_INIT;
+
+static Option onceSeven(void) {
+    __atomic_add_fetch(&onceCalls, 1, __ATOMIC_RELAXED);
+    // give the other threads a chance to pile up on the running initializer
+    sched_yield();
+    return Option_some(digits + 7);
+}
+
+static Option onceFailing(void) {
+    onceCalls++;
+    return None;
+}
+
+static Option onceContext(void *context) {
+    onceCalls++;
+    return Option_some(context);
+}
+
+static void *onceGetter(void *_) {
+    (void) _;
+    return (void *) Option_unwrap(OptionOnce_get(&onceShared, onceSeven));
+}
+
+Feature(OptionOnce_get) {
+    OptionOnce sut = OPTION_ONCE_INIT;
+    onceCalls = 0;
+    assert_true(Option_isNone(OptionOnce_peek(&sut)));
+
+    // None is not cached: the initializer is retried
+    assert_true(Option_isNone(OptionOnce_get(&sut, onceFailing)));
+    assert_true(Option_isNone(OptionOnce_get(&sut, onceFailing)));
+    assert_equal(onceCalls, 2);
+    assert_true(Option_isNone(OptionOnce_peek(&sut)));
+
+    assert_equal(OptionOnce_get(&sut, onceSeven).__value, digits + 7);
+    assert_equal(OptionOnce_get(&sut, onceFailing).__value, digits + 7);
+    assert_equal(OptionOnce_peek(&sut).__value, digits + 7);
+    assert_equal(onceCalls, 3);
+
+    OptionOnce other = OPTION_ONCE_INIT;
+    assert_equal(OptionOnce_getWith(&other, onceContext, (void *) (digits + 2)).__value, digits + 2);
+    assert_equal(OptionOnce_getWith(&other, onceContext, (void *) (digits + 3)).__value, digits + 2);
+    assert_equal(onceCalls, 4);
+}
+
+Feature(OptionOnce_threads) {
+    onceCalls = 0;
+    pthread_t threads[ONCE_THREADS];
+    for (size_t i = 0; i < ONCE_THREADS; i++) {
+        assert_equal(pthread_create(&threads[i], NULL, onceGetter, NULL), 0);
+    }
+    for (size_t i = 0; i < ONCE_THREADS; i++) {
+        void *value = NULL;
+        assert_equal(pthread_join(threads[i], &value), 0);
+        assert_equal(value, digits + 7);
+    }
+    assert_equal(onceCalls, 1);
+}
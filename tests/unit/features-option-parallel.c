@@ -0,0 +1,102 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <option-parallel.h>
+#include <traits/traits.h>
+#include "features.h"
+
+#define PARALLEL_LENGTH     100000
+
+static const void *parallelNext(const void *value) {
+    const int *digit = value;
+    return digit < digits + 9 ? digit + 1 : NULL;
+}
+
+static Option parallelEven(const void *value) {
+    const int *digit = value;
+    return *digit % 2 ? None : Option_some(digit);
+}
+
+static Option *parallelItems(void) {
+    Option *items = malloc(PARALLEL_LENGTH * sizeof(items[0]));
+    assert_not_null(items);
+    for (size_t i = 0; i < PARALLEL_LENGTH; i++) {
+        items[i] = i % 7 ? Option_some(digits + i % 10) : None;
+    }
+    return items;
+}
+
+Feature(OptionPool_new) {
+    OptionPool *sut = OptionPool_new(3);
+    assert_equal(OptionPool_workers(sut), 3);
+    OptionPool_delete(sut);
+
+    sut = OptionPool_new(0);
+    assert_greater_equal(OptionPool_workers(sut), 1);
+    OptionPool_delete(sut);
+}
+
+Feature(Option_parallelMap) {
+    Option *items = parallelItems(), *expected = parallelItems();
+    for (size_t i = 0; i < PARALLEL_LENGTH; i++) {
+        expected[i] = Option_map(expected[i], parallelNext);
+    }
+
+    for (size_t workers = 1; workers <= 4; workers++) {
+        OptionPool *sut = OptionPool_new(workers);
+        Option_parallelMap(sut, items, PARALLEL_LENGTH, parallelNext);
+        for (size_t i = 0; i < PARALLEL_LENGTH; i++) {
+            assert_equal(items[i].__value, expected[i].__value);
+        }
+        for (size_t i = 0; i < PARALLEL_LENGTH; i++) {
+            expected[i] = Option_map(expected[i], parallelNext);
+        }
+        OptionPool_delete(sut);
+    }
+    free(expected);
+    free(items);
+}
+
+Feature(Option_parallelChain) {
+    Option *items = parallelItems(), *expected = parallelItems();
+    for (size_t i = 0; i < PARALLEL_LENGTH; i++) {
+        expected[i] = Option_chain(expected[i], parallelEven);
+    }
+
+    OptionPool *sut = OptionPool_new(4);
+    Option_parallelChain(sut, items, PARALLEL_LENGTH, parallelEven);
+    for (size_t i = 0; i < PARALLEL_LENGTH; i++) {
+        assert_equal(items[i].__value, expected[i].__value);
+    }
+    // pools are reusable, small inputs run on the calling thread
+    Option_parallelChain(sut, items, 10, parallelEven);
+    Option_parallelChain(sut, NULL, 0, parallelEven);
+    OptionPool_delete(sut);
+    free(expected);
+    free(items);
+}
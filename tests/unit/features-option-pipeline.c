@@ -0,0 +1,131 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <option-pipeline.h>
+#include <traits/traits.h>
+#include "features.h"
+
+static const void *pipelineNext(const void *value) {
+    const int *digit = value;
+    return digit < digits + 9 ? digit + 1 : NULL;
+}
+
+static Option pipelineEven(const void *value) {
+    const int *digit = value;
+    return *digit % 2 ? None : Option_some(digit);
+}
+
+static Option pipelineZero(void) {
+    return Option_some(digits);
+}
+
+static Option pipelineReference(const Option input) {
+    return Option_orElse(
+            Option_map(Option_alt(Option_chain(Option_map(input, pipelineNext), pipelineEven), None), pipelineNext),
+            pipelineZero
+    );
+}
+
+static OptionPipeline *pipelineNew(void) {
+    return OptionPipeline_orElse(
+            OptionPipeline_map(
+                    OptionPipeline_alt(
+                            OptionPipeline_chain(OptionPipeline_map(OptionPipeline_new(), pipelineNext), pipelineEven),
+                            None
+                    ),
+                    pipelineNext
+            ),
+            pipelineZero
+    );
+}
+
+Feature(OptionPipeline_new) {
+    OptionPipeline *sut = OptionPipeline_new();
+    assert_equal(OptionPipeline_length(sut), 0);
+    assert_true(Option_isNone(OptionPipeline_run(sut, None)));
+    assert_equal(Option_unwrap(OptionPipeline_run(sut, Option_some(digits))), digits);
+    OptionPipeline_delete(sut);
+
+#if !defined(OPTION_UNCHECKED)
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+    traits_unit_wraps(SIGABRT) {
+        OptionPipeline_map(OptionPipeline_new(), NULL);
+    }
+    assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 1);
+#endif
+}
+
+Feature(OptionPipeline_run) {
+    OptionPipeline *sut = pipelineNew();
+    assert_equal(OptionPipeline_length(sut), 5);
+
+    assert_equal(OptionPipeline_run(sut, None).__value, pipelineReference(None).__value);
+    for (size_t i = 0; i < 10; i++) {
+        const Option input = Option_some(digits + i);
+        assert_equal(OptionPipeline_run(sut, input).__value, pipelineReference(input).__value);
+    }
+    OptionPipeline_delete(sut);
+}
+
+Feature(OptionPipeline_runAll) {
+    Option items[11], expected[11];
+    for (size_t i = 0; i < 10; i++) {
+        items[i] = Option_some(digits + i);
+        expected[i] = pipelineReference(items[i]);
+    }
+    items[10] = None;
+    expected[10] = pipelineReference(None);
+
+    OptionPipeline *sut = pipelineNew();
+    OptionPipeline_runAll(sut, items, 11);
+    for (size_t i = 0; i < 11; i++) {
+        assert_equal(items[i].__value, expected[i].__value);
+    }
+    OptionPipeline_delete(sut);
+}
+
+Feature(OptionPipeline_noneCount) {
+    Option items[11];
+    for (size_t i = 0; i < 10; i++) {
+        items[i] = Option_some(digits + i);
+    }
+    items[10] = None;
+
+    OptionPipeline *sut = pipelineNew();
+    OptionPipeline_runAll(sut, items, 11);
+    assert_equal(OptionPipeline_noneCount(sut, 0), 1);     // map: 9 has no successor
+    assert_equal(OptionPipeline_noneCount(sut, 1), 5);     // chain: 1, 3, 5, 7, 9 are odd
+    assert_equal(OptionPipeline_noneCount(sut, 2), 7);     // alt: None does not recover
+    assert_equal(OptionPipeline_noneCount(sut, 3), 0);     // map: every even digit has a successor
+    assert_equal(OptionPipeline_noneCount(sut, 4), 0);     // orElse: always recovers
+
+    OptionPipeline_resetCounters(sut);
+    for (size_t i = 0; i < OptionPipeline_length(sut); i++) {
+        assert_equal(OptionPipeline_noneCount(sut, i), 0);
+    }
+    OptionPipeline_delete(sut);
+}
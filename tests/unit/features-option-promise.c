@@ -0,0 +1,108 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <pthread.h>
+#include <option-promise.h>
+#include <traits/traits.h>
+#include "features.h"
+
+#define PROMISE_THREADS     4
+
+static Option promiseEven(const void *value) {
+    const int *digit = value;
+    return *digit % 2 ? None : Option_some(digit);
+}
+
+static Option promiseNext(const void *value) {
+    const int *digit = value;
+    return digit < digits + 9 ? Option_some(digit + 1) : None;
+}
+
+static void *promiseWaiter(void *promise) {
+    return (void *) Option_unwrap(OptionPromise_wait(promise));
+}
+
+static void *promiseFulfiller(void *promise) {
+    OptionPromise_fulfill(promise, digits + 7);
+    return NULL;
+}
+
+Feature(OptionPromise_fulfill) {
+    OptionPromise sut = OPTION_PROMISE_INIT;
+    assert_true(Option_isNone(OptionPromise_poll(&sut)));
+    assert_true(Option_isNone(OptionPromise_waitFor(&sut, 1000000)));
+
+    OptionPromise_fulfill(&sut, digits + 3);
+    assert_equal(OptionPromise_poll(&sut).__value, digits + 3);
+    assert_equal(OptionPromise_wait(&sut).__value, digits + 3);
+    assert_equal(OptionPromise_waitFor(&sut, 0).__value, digits + 3);
+
+#if !defined(OPTION_UNCHECKED)
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+    traits_unit_wraps(SIGABRT) {
+        OptionPromise_fulfill(&sut, digits + 4);
+    }
+    assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 1);
+    assert_equal(OptionPromise_poll(&sut).__value, digits + 3);
+#endif
+}
+
+Feature(OptionPromise_wait) {
+    OptionPromise sut;
+    OptionPromise_init(&sut);
+    pthread_t waiters[PROMISE_THREADS], fulfiller;
+    for (size_t i = 0; i < PROMISE_THREADS; i++) {
+        assert_equal(pthread_create(&waiters[i], NULL, promiseWaiter, &sut), 0);
+    }
+    assert_equal(pthread_create(&fulfiller, NULL, promiseFulfiller, &sut), 0);
+    assert_equal(pthread_join(fulfiller, NULL), 0);
+    for (size_t i = 0; i < PROMISE_THREADS; i++) {
+        void *value = NULL;
+        assert_equal(pthread_join(waiters[i], &value), 0);
+        assert_equal(value, digits + 7);
+    }
+}
+
+Feature(OptionPromise_then) {
+    OptionPromise sut = OPTION_PROMISE_INIT;
+    OptionPromiseContinuation even, next, late;
+    OptionPromise_then(&sut, &even, promiseEven);
+    OptionPromise_then(&sut, &next, promiseNext);
+    assert_false(OptionPromiseContinuation_isDone(&even));
+    assert_true(Option_isNone(OptionPromiseContinuation_result(&next)));
+
+    OptionPromise_fulfill(&sut, digits + 5);
+    assert_true(OptionPromiseContinuation_isDone(&even));
+    assert_true(Option_isNone(OptionPromiseContinuation_result(&even)));
+    assert_true(OptionPromiseContinuation_isDone(&next));
+    assert_equal(OptionPromiseContinuation_result(&next).__value, digits + 6);
+
+    // registered after the fulfilment: runs immediately
+    OptionPromise_then(&sut, &late, promiseNext);
+    assert_true(OptionPromiseContinuation_isDone(&late));
+    assert_equal(OptionPromiseContinuation_result(&late).__value, digits + 6);
+}
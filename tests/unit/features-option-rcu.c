@@ -0,0 +1,125 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <sched.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <option-rcu.h>
+#include <traits/traits.h>
+#include "features.h"
+
+#define RCU_READERS     4
+#define RCU_VERSIONS    200
+#define RCU_MAGIC       0x5eed
+
+typedef struct RcuConfig {
+    int magic;
+    int version;
+} RcuConfig;
+
+static OptionRcu rcuShared = OPTION_RCU_INIT;
+static int rcuStop = 0;
+static size_t rcuReclaimed = 0;
+
+static RcuConfig *rcuConfig(const int version) {
+    RcuConfig *config = malloc(sizeof(*config));
+    assert_not_null(config);
+    *config = (RcuConfig) {.magic=RCU_MAGIC, .version=version};
+    return config;
+}
+
+static void rcuReclaim(void *value) {
+    // poison the value, so that readers still using it would notice
+    ((RcuConfig *) value)->magic = 0;
+    __atomic_add_fetch(&rcuReclaimed, 1, __ATOMIC_RELAXED);
+    free(value);
+}
+
+static void *rcuReader(void *_) {
+    (void) _;
+    size_t failures = 0;
+    int last = 0;
+    while (!__atomic_load_n(&rcuStop, __ATOMIC_ACQUIRE)) {
+        OptionRcu_readLock();
+        const RcuConfig *config = Option_unwrap(OptionRcu_read(&rcuShared));
+        sched_yield();
+        failures += RCU_MAGIC != config->magic || config->version < last;
+        last = config->version;
+        OptionRcu_readUnlock();
+    }
+    return (void *) failures;
+}
+
+Feature(OptionRcu_publish) {
+    OptionRcu sut = OPTION_RCU_INIT;
+    rcuReclaimed = 0;
+    OptionRcu_readLock();
+    assert_true(Option_isNone(OptionRcu_read(&sut)));
+    OptionRcu_readUnlock();
+
+    OptionRcu_publish(&sut, Option_some(rcuConfig(1)), rcuReclaim);
+    assert_equal(rcuReclaimed, 0);
+    OptionRcu_readLock();
+    OptionRcu_readLock();
+    assert_equal(((const RcuConfig *) Option_unwrap(OptionRcu_read(&sut)))->version, 1);
+    OptionRcu_readUnlock();
+    OptionRcu_readUnlock();
+
+    OptionRcu_publish(&sut, Option_some(rcuConfig(2)), rcuReclaim);
+    assert_equal(rcuReclaimed, 1);
+    OptionRcu_publish(&sut, None, rcuReclaim);
+    assert_equal(rcuReclaimed, 2);
+
+#if !defined(OPTION_UNCHECKED)
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+    traits_unit_wraps(SIGABRT) {
+        OptionRcu_readUnlock();
+    }
+    assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 1);
+#endif
+}
+
+Feature(OptionRcu_threads) {
+    rcuReclaimed = 0;
+    OptionRcu_publish(&rcuShared, Option_some(rcuConfig(0)), rcuReclaim);
+    pthread_t readers[RCU_READERS];
+    for (size_t i = 0; i < RCU_READERS; i++) {
+        assert_equal(pthread_create(&readers[i], NULL, rcuReader, NULL), 0);
+    }
+    for (int version = 1; version <= RCU_VERSIONS; version++) {
+        OptionRcu_publish(&rcuShared, Option_some(rcuConfig(version)), rcuReclaim);
+        sched_yield();
+    }
+    __atomic_store_n(&rcuStop, 1, __ATOMIC_RELEASE);
+    for (size_t i = 0; i < RCU_READERS; i++) {
+        void *failures = NULL;
+        assert_equal(pthread_join(readers[i], &failures), 0);
+        assert_equal(failures, NULL);
+    }
+    assert_equal(rcuReclaimed, RCU_VERSIONS);
+    OptionRcu_publish(&rcuShared, None, rcuReclaim);
+}
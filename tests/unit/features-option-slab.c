@@ -0,0 +1,129 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <option-slab.h>
+#include <traits/traits.h>
+#include "features.h"
+
+typedef struct {
+    OptionSlab *slab;
+    void *objects[4];
+} SlabTask;
+
+static void *slabAllocate(void *data) {
+    SlabTask *task = data;
+    for (size_t i = 0; i < 4; i++) {
+        task->objects[i] = Option_unwrapAsMutable(OptionSlab_alloc(task->slab));
+    }
+    return NULL;
+}
+
+static void *slabFree(void *data) {
+    SlabTask *task = data;
+    for (size_t i = 0; i < 4; i++) {
+        OptionSlab_free(task->slab, task->objects[i]);
+    }
+    OptionSlab_flush(task->slab);
+    return NULL;
+}
+
+static void *slabAllocateAndFree(void *data) {
+    slabAllocate(data);
+    slabFree(data);
+    return NULL;
+}
+
+static void slabRun(void *f(void *), SlabTask *task) {
+    pthread_t thread;
+    assert_equal(pthread_create(&thread, NULL, f, task), 0);
+    assert_equal(pthread_join(thread, NULL), 0);
+}
+
+Feature(OptionSlab_alloc) {
+    OptionSlab *sut = OptionSlab_new(20);
+    assert_equal(OptionSlab_objectSize(sut), 32);
+
+    char *objects[200];
+    for (size_t i = 0; i < 200; i++) {
+        objects[i] = Option_unwrapAsMutable(OptionSlab_alloc(sut));
+        assert_equal((uintptr_t) objects[i] % 16, 0);
+        memset(objects[i], (int) i, 20);
+    }
+    for (size_t i = 0; i < 200; i++) {
+        assert_equal(objects[i][19], (char) i);
+    }
+
+    // freed objects are reused first
+    OptionSlab_free(sut, objects[7]);
+    OptionSlab_free(sut, NULL);
+    assert_equal(Option_unwrapAsMutable(OptionSlab_alloc(sut)), objects[7]);
+    OptionSlab_delete(sut);
+}
+
+Feature(OptionSlab_free) {
+    OptionSlab *sut = OptionSlab_new(sizeof(int));
+    SlabTask task = {.slab=sut};
+    for (size_t i = 0; i < 4; i++) {
+        task.objects[i] = Option_unwrapAsMutable(OptionSlab_alloc(sut));
+    }
+
+    // objects freed by another thread return to this one, once its local objects are exhausted
+    slabRun(slabFree, &task);
+    bool returned[4] = {false};
+    for (size_t i = 0; i < 128; i++) {
+        void *object = Option_unwrapAsMutable(OptionSlab_alloc(sut));
+        for (size_t j = 0; j < 4; j++) {
+            returned[j] |= object == task.objects[j];
+        }
+    }
+    for (size_t j = 0; j < 4; j++) {
+        assert_true(returned[j]);
+    }
+    OptionSlab_delete(sut);
+}
+
+Feature(OptionSlab_threads) {
+    OptionSlab *sut = OptionSlab_new(sizeof(int));
+    SlabTask first = {.slab=sut}, second = {.slab=sut};
+
+    // the cache of an exited thread is adopted by the next one
+    slabRun(slabAllocateAndFree, &first);
+    slabRun(slabAllocate, &second);
+    for (size_t i = 0; i < 4; i++) {
+        assert_equal(second.objects[i], first.objects[3 - i]);
+    }
+
+    // frees from a thread other than the owner
+    SlabTask mine = {.slab=sut};
+    slabAllocate(&mine);
+    slabRun(slabFree, &second);
+    slabFree(&mine);
+    OptionSlab_delete(sut);
+}
@@ -0,0 +1,199 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <option-vector.h>
+#include <traits/traits.h>
+#include "features.h"
+
+#define VECTOR_LENGTH   150
+
+static const int numbers[VECTOR_LENGTH] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+        25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49,
+        50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74,
+        75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99,
+        100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121,
+        122, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142, 143,
+        144, 145, 146, 147, 148, 149,
+};
+
+static bool vectorIncrement(void *value) {
+    int *number = value;
+    *number += 1;
+    return *number % 3 != 1;
+}
+
+static bool vectorIsEven(const void *value) {
+    const int *number = value;
+    return *number % 2 == 0;
+}
+
+Feature(OptionVector_new) {
+    OptionVector *sut = OptionVector_new(VECTOR_LENGTH, sizeof(int));
+    assert_equal(OptionVector_length(sut), VECTOR_LENGTH);
+    assert_equal(OptionVector_elementSize(sut), sizeof(int));
+    assert_equal(OptionVector_countSome(sut), 0);
+    assert_equal((uintptr_t) OptionVector_values(sut) % sizeof(int), 0);
+    for (size_t i = 0; i < VECTOR_LENGTH; i++) {
+        assert_true(Option_isNone(OptionVector_get(sut, i)));
+    }
+    OptionVector_delete(sut);
+
+    // overflows are not caller contracts: they panic even when contracts are unchecked
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+    traits_unit_wraps(SIGABRT) {
+        OptionVector *_ = OptionVector_new(SIZE_MAX / 2, sizeof(int));
+        (void) _;
+    }
+    traits_unit_wraps(SIGABRT) {
+        OptionVector *_ = OptionVector_new(2, SIZE_MAX);
+        (void) _;
+    }
+    traits_unit_wraps(SIGABRT) {
+        OptionVector *_ = OptionVector_new(1, SIZE_MAX / 2 + 1);
+        (void) _;
+    }
+    assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 3);
+
+#if !defined(OPTION_UNCHECKED)
+    traits_unit_wraps(SIGABRT) {
+        OptionVector *_ = OptionVector_new(VECTOR_LENGTH, 0);
+        (void) _;
+    }
+    assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 4);
+#endif
+}
+
+Feature(OptionVector_fromArray) {
+    Option items[VECTOR_LENGTH];
+    for (size_t i = 0; i < VECTOR_LENGTH; i++) {
+        items[i] = i % 4 ? Option_some(numbers + i) : None;
+    }
+
+    OptionVector *sut = OptionVector_fromArray(items, VECTOR_LENGTH, sizeof(int));
+    const int *values = OptionVector_values(sut);
+    assert_equal(OptionVector_countSome(sut), VECTOR_LENGTH - (VECTOR_LENGTH + 3) / 4);
+    for (size_t i = 0; i < VECTOR_LENGTH; i++) {
+        const Option sutItem = OptionVector_get(sut, i);
+        assert_equal(Option_isSome(sutItem), Option_isSome(items[i]));
+        if (Option_isSome(sutItem)) {
+            assert_equal(Option_unwrap(sutItem), values + i);
+            assert_equal(values[i], numbers[i]);
+        }
+    }
+    assert_equal(OptionVector_validity(sut)[VECTOR_LENGTH / 64] >> (VECTOR_LENGTH % 64), 0);
+    OptionVector_delete(sut);
+}
+
+Feature(OptionVector_set) {
+    OptionVector *sut = OptionVector_new(VECTOR_LENGTH, sizeof(int));
+    int value = 70;
+    OptionVector_set(sut, 70, Option_some(&value));
+    value = 0;
+    assert_equal(*(const int *) Option_unwrap(OptionVector_get(sut, 70)), 70);
+    assert_equal(OptionVector_countSome(sut), 1);
+    *(int *) Option_unwrapAsMutable(OptionVector_get(sut, 70)) = 71;
+    assert_equal(((const int *) OptionVector_values(sut))[70], 71);
+    OptionVector_set(sut, 70, None);
+    assert_true(Option_isNone(OptionVector_get(sut, 70)));
+    assert_equal(OptionVector_countSome(sut), 0);
+
+#if !defined(OPTION_UNCHECKED)
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+    traits_unit_wraps(SIGABRT) {
+        const Option _ = OptionVector_get(sut, VECTOR_LENGTH);
+        (void) _;
+    }
+    assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 1);
+#endif
+    OptionVector_delete(sut);
+}
+
+Feature(OptionVector_map) {
+    OptionVector *sut = OptionVector_new(VECTOR_LENGTH, sizeof(int));
+    for (size_t i = 0; i < VECTOR_LENGTH; i += 2) {
+        OptionVector_set(sut, i, Option_some(numbers + i));
+    }
+
+    OptionVector_map(sut, vectorIncrement);
+    for (size_t i = 0; i < VECTOR_LENGTH; i++) {
+        const Option sutItem = OptionVector_get(sut, i);
+        assert_equal(Option_isSome(sutItem), i % 2 == 0 && (numbers[i] + 1) % 3 != 1);
+        if (Option_isSome(sutItem)) {
+            assert_equal(*(const int *) Option_unwrap(sutItem), numbers[i] + 1);
+        }
+    }
+    OptionVector_delete(sut);
+}
+
+Feature(OptionVector_filter) {
+    Option items[VECTOR_LENGTH];
+    for (size_t i = 0; i < VECTOR_LENGTH; i++) {
+        items[i] = i % 3 ? Option_some(numbers + i) : None;
+    }
+
+    OptionVector *sut = OptionVector_fromArray(items, VECTOR_LENGTH, sizeof(int));
+    OptionVector_filter(sut, vectorIsEven);
+    for (size_t i = 0; i < VECTOR_LENGTH; i++) {
+        assert_equal(Option_isSome(OptionVector_get(sut, i)), i % 3 != 0 && i % 2 == 0);
+    }
+    OptionVector_delete(sut);
+}
+
+Feature(OptionVector_alt) {
+    OptionVector *sut = OptionVector_new(VECTOR_LENGTH, sizeof(int));
+    OptionVector *other = OptionVector_new(VECTOR_LENGTH, sizeof(int));
+    for (size_t i = 0; i < VECTOR_LENGTH; i++) {
+        if (i % 2) {
+            OptionVector_set(sut, i, Option_some(numbers + i));
+        }
+        if (i % 3) {
+            OptionVector_set(other, i, Option_some(numbers));
+        }
+    }
+
+    OptionVector_alt(sut, other);
+    for (size_t i = 0; i < VECTOR_LENGTH; i++) {
+        const Option sutItem = OptionVector_get(sut, i);
+        assert_equal(Option_isSome(sutItem), i % 2 != 0 || i % 3 != 0);
+        if (Option_isSome(sutItem)) {
+            assert_equal(*(const int *) Option_unwrap(sutItem), i % 2 ? numbers[i] : numbers[0]);
+        }
+    }
+
+#if !defined(OPTION_UNCHECKED)
+    OptionVector *mismatch = OptionVector_new(VECTOR_LENGTH, sizeof(long));
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+    traits_unit_wraps(SIGABRT) {
+        OptionVector_alt(sut, mismatch);
+    }
+    assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 1);
+    OptionVector_delete(mismatch);
+#endif
+    OptionVector_delete(other);
+    OptionVector_delete(sut);
+}
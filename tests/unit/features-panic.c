@@ -0,0 +1,323 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <math.h>
+#include <float.h>
+#include <stdio.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <panic/panic.h>
+#include <traits/traits.h>
+#include "features.h"
+
+typedef struct {
+    char trace[8];
+    size_t length;
+    int line;
+    int error;
+    long threadId;
+    char cause[64];
+} HookRecord;
+
+static HookRecord hookRecord;
+
+static void hookRecordCalled(const Panic_Report *report, void *context) {
+    const char *name = context;
+    hookRecord.trace[hookRecord.length++] = name[0];
+    hookRecord.line = report->line;
+    hookRecord.error = report->error;
+    hookRecord.threadId = report->threadId;
+    strncpy(hookRecord.cause, report->cause, sizeof(hookRecord.cause) - 1);
+}
+
+static void callbackRecordCalled(void) {
+    hookRecord.trace[hookRecord.length++] = '!';
+}
+
+Feature(Panic_registerCallback) {
+    assert_equal(Panic_registerCallback(callbackRecordCalled), NULL);
+    assert_equal(Panic_registerCallback(NULL), callbackRecordCalled);
+    assert_equal(Panic_registerCallback(callbackRecordCalled), NULL);
+
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+    traits_unit_wraps(SIGABRT) {
+        Panic_terminate("callback");
+    }
+    assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 1);
+    assert_equal(hookRecord.length, 1);
+    assert_equal(hookRecord.trace[0], '!');
+}
+
+Feature(Panic_registerHook) {
+    assert_true(Panic_registerHook(hookRecordCalled, "b", 0));
+    assert_true(Panic_registerHook(hookRecordCalled, "a", 10));
+    assert_true(Panic_registerHook(hookRecordCalled, "c", 0));
+    assert_true(Panic_registerHook(hookRecordCalled, "d", -10));
+    Panic_registerCallback(callbackRecordCalled);
+
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+    volatile int line = 0;
+    traits_unit_wraps(SIGABRT) {
+        errno = ENOENT;
+        line = __LINE__, Panic_terminate("hook %d", 42);
+    }
+    assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 1);
+    assert_string_equal(hookRecord.trace, "abcd!");
+    assert_equal(hookRecord.line, line);
+    assert_equal(hookRecord.error, ENOENT);
+    assert_not_equal(hookRecord.threadId, 0);
+    assert_string_equal(hookRecord.cause, "hook 42");
+}
+
+Feature(Panic_unregisterHook) {
+    assert_true(Panic_registerHook(hookRecordCalled, "a", 0));
+    assert_true(Panic_registerHook(hookRecordCalled, "b", 0));
+    assert_true(Panic_unregisterHook(hookRecordCalled, "a"));
+    assert_false(Panic_unregisterHook(hookRecordCalled, "a"));
+    assert_false(Panic_unregisterHook(hookRecordCalled, "c"));
+
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+    traits_unit_wraps(SIGABRT) {
+        Panic_terminate("unregister");
+    }
+    assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 1);
+    assert_string_equal(hookRecord.trace, "b");
+}
+
+static void panicAtSameSite(void) {
+    Panic_terminate("sink \"%s\"\n", "quoted");
+}
+
+Feature(Panic_setReportSink) {
+    FILE *sink = tmpfile();
+    assert_not_null(sink);
+    assert_equal(Panic_setReportSink(fileno(sink)), -1);
+
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+    for (size_t i = 0; i < 2; i++) {
+        traits_unit_wraps(SIGABRT) {
+            errno = EINVAL;
+            panicAtSameSite();
+        }
+    }
+    assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 2);
+    assert_equal(Panic_setReportSink(-1), fileno(sink));
+
+    char content[8192] = "";
+    assert_equal(lseek(fileno(sink), 0, SEEK_SET), 0);
+    assert_greater(read(fileno(sink), content, sizeof(content) - 1), 0);
+    char *second = strchr(content, '\n');
+    assert_not_null(second);
+    *second++ = '\0';
+
+    assert_equal(content[0], '{');
+    assert_not_null(strstr(content, "\"cause\":\"sink \\\"quoted\\\"\\n\""));
+    assert_not_null(strstr(content, "\"siteCount\":1,"));
+    assert_not_null(strstr(second, "\"siteCount\":2,"));
+    assert_not_null(strstr(second, "\"errno\":22,"));
+    assert_not_null(strstr(second, "\"file\":\"" __FILE__ "\""));
+    fclose(sink);
+}
+
+static bool isOpen(const int fd) {
+    return -1 != fcntl(fd, F_GETFD);
+}
+
+Feature(Panic_openReportSink) {
+    char first[] = "/tmp/panic-sink-XXXXXX", second[] = "/tmp/panic-sink-XXXXXX";
+    const int firstTemporary = mkstemp(first), secondTemporary = mkstemp(second);
+    assert_greater_equal(firstTemporary, 0);
+    assert_greater_equal(secondTemporary, 0);
+    close(firstTemporary);
+    close(secondTemporary);
+
+    // the sink opened by the library is closed when it opens the next one
+    const int opened = Panic_openReportSink(first);
+    assert_greater_equal(opened, 0);
+    assert_greater_equal(Panic_openReportSink(second), 0);
+    assert_false(isOpen(opened));
+
+    // a sink set by the caller, or handed back to it, is never closed by the library
+    FILE *sink = tmpfile();
+    assert_not_null(sink);
+    const int handedBack = Panic_setReportSink(fileno(sink));
+    assert_true(isOpen(handedBack));
+    assert_greater_equal(Panic_openReportSink(first), 0);
+    assert_true(isOpen(fileno(sink)));
+    assert_true(isOpen(handedBack));
+    assert_greater_equal(Panic_openReportSink(second), 0);
+    assert_true(isOpen(handedBack));
+
+    close(handedBack);
+    close(Panic_setReportSink(-1));
+    fclose(sink);
+    unlink(first);
+    unlink(second);
+}
+
+/*
+ * The formatter of the reports is compared against snprintf, one table per argument type.
+ */
+#define FORMAT_SIZE     256
+
+#define assert_formats_like_snprintf(format, value)                                                                    \
+    do {                                                                                                               \
+        char expected[FORMAT_SIZE] = "", actual[FORMAT_SIZE] = "";                                                     \
+        snprintf(expected, sizeof(expected), (format), (value));                                                       \
+        __Panic_format(actual, sizeof(actual), (format), (value));                                                     \
+        assert_string_equal(actual, expected);                                                                         \
+    } while (false)
+
+static const struct {
+    const char *format;
+    int value;
+} intCases[] = {
+        {"%d",      0},         {"%d",      INT_MIN},   {"%d",      INT_MAX},   {"%i",      -1},
+        {"%5d",     42},        {"%-5d|",   42},        {"%05d",    -42},       {"%+d",     42},
+        {"% d",     42},        {"%+d",     -42},       {"%.0d",    0},         {"%.3d",    7},
+        {"%8.3d",   -7},        {"%-8.3d|", -7},        {"%+.0d",   0},         {"%hhd",    300},
+        {"%hd",     70000},     {"%u",      -1},        {"%hhu",    300},       {"%hu",     -1},
+        {"%x",      255},       {"%X",      255},       {"%#x",     255},       {"%#X",     255},
+        {"%#x",     0},         {"%#08x",   255},       {"%08.4x",  255},       {"%o",      8},
+        {"%#o",     8},         {"%#o",     0},         {"%#.0o",   0},         {"%.0x",    0},
+        {"%c",      'A'},       {"%3c",     'A'},       {"%-3c|",   'A'},       {"%x",      INT_MIN},
+};
+
+static const struct {
+    const char *format;
+    long long value;
+} longLongCases[] = {
+        {"%lld",    LLONG_MIN}, {"%lld",    LLONG_MAX}, {"%llu",    -1},        {"%llx",    -1},
+        {"%llo",    -1},        {"%+lld",   0},         {"%020lld", LLONG_MIN}, {"%-22lld|", LLONG_MAX},
+};
+
+static const struct {
+    const char *format;
+    double value;
+} doubleCases[] = {
+        {"%f",      0.0},       {"%f",      -0.0},      {"%f",      1.5},       {"%f",      -1.5},
+        {"%.2f",    0.125},     {"%.2f",    0.375},     {"%.2f",    2.675},     {"%.1f",    0.15},
+        {"%.0f",    0.5},       {"%.0f",    1.5},       {"%.0f",    2.5},       {"%.0f",    -3.5},
+        {"%#.0f",   3.0},       {"%.10f",   1.0 / 3},   {"%.18f",   0.1},       {"%f",      1e17},
+        {"%f",      0.9999999}, {"%.3f",    9.9995},    {"%+f",     1.0},       {"% f",     1.0},
+        {"%010.3f", -3.14159},  {"%-10.2f|", 3.14159},  {"%12f",    -1.0},      {"%f",      1e-10},
+        {"%e",      0.0},       {"%e",      123.456},   {"%e",      -123.456},  {"%.0e",    5.0},
+        {"%#.0e",   5.0},       {"%.3e",    9.9999999}, {"%e",      1e300},     {"%e",      1e-300},
+        {"%e",      DBL_MAX},   {"%e",      DBL_MIN},   {"%e",      5e-324},    {"%E",      1e10},
+        {"%+.2e",   1e100},     {"%012.3e", -1234.5},   {"%-12.2e|", 1234.5},   {"%e",      1e-5},
+        {"%g",      0.0},       {"%g",      100000.0},  {"%g",      1000000.0}, {"%g",      1e-4},
+        {"%g",      1e-5},      {"%g",      123.456},   {"%g",      0.0001234}, {"%g",      9.9999995},
+        {"%.0g",    0.5},       {"%.1g",    15.0},      {"%.3g",    1234.5},    {"%#g",     1.0},
+        {"%#.3g",   1e-10},     {"%G",      1e-10},     {"%g",      1e300},     {"%g",      -2.5},
+        {"%f",      INFINITY},  {"%F",      -INFINITY}, {"%e",      INFINITY},  {"%G",      INFINITY},
+        {"%f",      NAN},       {"%F",      NAN},       {"%08f",    INFINITY},  {"%-6f|",   NAN},
+};
+
+static const struct {
+    const char *format;
+    const char *value;
+} stringCases[] = {
+        {"%s",      "abc"},     {"%.2s",    "abc"},     {"%.0s",    "abc"},     {"%5s",     "abc"},
+        {"%-5s|",   "abc"},     {"%5.1s",   "abc"},     {"%s",      ""},        {"%s",      NULL},
+        {"%%%s%%",  "abc"},     {"100%% %s", "abc"},
+};
+
+static const struct {
+    const char *format;
+    const void *value;
+} pointerCases[] = {
+        {"%p",      &hookRecord},   {"%20p",    &hookRecord},   {"%-20p|",  &hookRecord},
+        {"%p",      NULL},          {"%8p",     NULL},
+};
+
+Feature(Panic_formatIntegers) {
+    for (size_t i = 0; i < sizeof(intCases) / sizeof(intCases[0]); i++) {
+        assert_formats_like_snprintf(intCases[i].format, intCases[i].value);
+    }
+    for (size_t i = 0; i < sizeof(longLongCases) / sizeof(longLongCases[0]); i++) {
+        assert_formats_like_snprintf(longLongCases[i].format, longLongCases[i].value);
+    }
+    assert_formats_like_snprintf("%jd", INTMAX_MIN);
+    assert_formats_like_snprintf("%zu", SIZE_MAX);
+    assert_formats_like_snprintf("%zx", SIZE_MAX);
+    assert_formats_like_snprintf("%td", PTRDIFF_MIN);
+    assert_formats_like_snprintf("%ld", LONG_MIN);
+    assert_formats_like_snprintf("%lu", ULONG_MAX);
+
+    char expected[FORMAT_SIZE] = "", actual[FORMAT_SIZE] = "";
+    snprintf(expected, sizeof(expected), "%*d|%-*d|%.*d|%*.*d", 6, 1, 6, 2, 3, 3, -6, -3, 4);
+    __Panic_format(actual, sizeof(actual), "%*d|%-*d|%.*d|%*.*d", 6, 1, 6, 2, 3, 3, -6, -3, 4);
+    assert_string_equal(actual, expected);
+}
+
+Feature(Panic_formatDoubles) {
+    for (size_t i = 0; i < sizeof(doubleCases) / sizeof(doubleCases[0]); i++) {
+        assert_formats_like_snprintf(doubleCases[i].format, doubleCases[i].value);
+    }
+    assert_formats_like_snprintf("%Lf", 1.5L);
+    assert_formats_like_snprintf("%Le", -1e-20L);
+
+    // documented limits: fixed notation switches to scientific notation from 1e18, precision is capped at 18 digits
+    char actual[FORMAT_SIZE] = "";
+    __Panic_format(actual, sizeof(actual), "%f", 1e300);
+    assert_string_equal(actual, "1.000000e+300");
+    __Panic_format(actual, sizeof(actual), "%.20f", 0.5);
+    assert_string_equal(actual, "0.500000000000000000");
+}
+
+Feature(Panic_formatStrings) {
+    for (size_t i = 0; i < sizeof(stringCases) / sizeof(stringCases[0]); i++) {
+        assert_formats_like_snprintf(stringCases[i].format, stringCases[i].value);
+    }
+    for (size_t i = 0; i < sizeof(pointerCases) / sizeof(pointerCases[0]); i++) {
+        assert_formats_like_snprintf(pointerCases[i].format, pointerCases[i].value);
+    }
+
+    // unsupported conversions are copied verbatim, a double argument left unconsumed does not shift the integer ones
+    char actual[FORMAT_SIZE] = "";
+    __Panic_format(actual, sizeof(actual), "%a|%d", 1.0, 7);
+    assert_string_equal(actual, "%a|7");
+}
+
+Feature(Panic_formatTruncation) {
+    // a 16 bytes buffer keeps 10 characters, the rest is taken by the "...\r\n" marker and the terminator
+    char actual[16] = "";
+    assert_equal(__Panic_format(actual, sizeof(actual), "%s", "abcdefghij"), 10);
+    assert_string_equal(actual, "abcdefghij");
+    assert_equal(__Panic_format(actual, sizeof(actual), "%s", "abcdefghijk"), 15);
+    assert_string_equal(actual, "abcdefghij...\r\n");
+    assert_equal(__Panic_format(actual, sizeof(actual), "%lld", LLONG_MIN), 15);
+    assert_string_equal(actual, "-922337203...\r\n");
+    assert_equal(__Panic_format(actual, sizeof(actual), "%-40e|", -1.5), 15);
+    assert_string_equal(actual, "-1.500000e...\r\n");
+    assert_equal(__Panic_format(actual, sizeof(actual), "%040.3f", 2.0), 15);
+    assert_string_equal(actual, "0000000000...\r\n");
+}
@@ -0,0 +1,216 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <typed-option.h>
+#include <traits/traits.h>
+#include "features.h"
+
+OPTION_DEFINE(double, OptionDouble)
+OPTION_DEFINE_SENTINEL(int, OptionPort, 0)
+
+static double doubleIncrement(const double value) {
+    return value + 1;
+}
+
+static double doubleUnreachable(const double value) {
+    (void) value;
+    assert_true(false);
+    return 0;
+}
+
+static OptionDouble doubleHalf(const double value) {
+    return value < 0 ? OptionDouble_none() : OptionDouble_some(value / 2);
+}
+
+static OptionDouble doubleChainUnreachable(const double value) {
+    (void) value;
+    assert_true(false);
+    return OptionDouble_none();
+}
+
+static OptionDouble doubleFallback(void) {
+    return OptionDouble_some(42);
+}
+
+Feature(TypedOption_some) {
+    const OptionDouble sut = OptionDouble_some(3.5);
+    assert_true(OptionDouble_isSome(sut));
+    assert_false(OptionDouble_isNone(sut));
+    assert_equal(OPTION_UNWRAP(OptionDouble, sut), 3.5);
+}
+
+Feature(TypedOption_none) {
+    const OptionDouble sut = OptionDouble_none();
+    assert_true(OptionDouble_isNone(sut));
+    assert_false(OptionDouble_isSome(sut));
+}
+
+Feature(TypedOption_map) {
+    {
+        const OptionDouble sut = OptionDouble_map(OptionDouble_none(), doubleUnreachable);
+        assert_true(OptionDouble_isNone(sut));
+    }
+
+    {
+        const OptionDouble sut = OptionDouble_map(OptionDouble_some(1), doubleIncrement);
+        assert_true(OptionDouble_isSome(sut));
+        assert_equal(OPTION_UNWRAP(OptionDouble, sut), 2.0);
+    }
+}
+
+Feature(TypedOption_chain) {
+    {
+        const OptionDouble sut = OptionDouble_chain(OptionDouble_none(), doubleChainUnreachable);
+        assert_true(OptionDouble_isNone(sut));
+    }
+
+    {
+        const OptionDouble sut = OptionDouble_chain(OptionDouble_some(-1), doubleHalf);
+        assert_true(OptionDouble_isNone(sut));
+    }
+
+    {
+        const OptionDouble sut = OptionDouble_chain(OptionDouble_some(8), doubleHalf);
+        assert_true(OptionDouble_isSome(sut));
+        assert_equal(OPTION_UNWRAP(OptionDouble, sut), 4.0);
+    }
+}
+
+Feature(TypedOption_alt) {
+    {
+        const OptionDouble sut = OptionDouble_alt(OptionDouble_none(), OptionDouble_some(7));
+        assert_equal(OPTION_UNWRAP(OptionDouble, sut), 7.0);
+    }
+
+    {
+        const OptionDouble sut = OptionDouble_alt(OptionDouble_some(1), OptionDouble_some(7));
+        assert_equal(OPTION_UNWRAP(OptionDouble, sut), 1.0);
+    }
+}
+
+Feature(TypedOption_orElse) {
+    {
+        const OptionDouble sut = OptionDouble_orElse(OptionDouble_none(), doubleFallback);
+        assert_equal(OPTION_UNWRAP(OptionDouble, sut), 42.0);
+    }
+
+    {
+        const OptionDouble sut = OptionDouble_orElse(OptionDouble_some(1), doubleFallback);
+        assert_equal(OPTION_UNWRAP(OptionDouble, sut), 1.0);
+    }
+}
+
+Feature(TypedOption_unwrap) {
+    assert_equal(OPTION_UNWRAP(OptionDouble, OptionDouble_some(1)), 1.0);
+
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+    traits_unit_wraps(SIGABRT) {
+        const double _ = OPTION_UNWRAP(OptionDouble, OptionDouble_none());
+        (void) _;
+    }
+    assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 1);
+}
+
+Feature(TypedOption_expect) {
+    assert_equal(OPTION_EXPECT(OptionDouble, OptionDouble_some(1), "%s", "Expected a value"), 1.0);
+
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+    traits_unit_wraps(SIGABRT) {
+        const double _ = OPTION_EXPECT(OptionDouble, OptionDouble_none(), "%s", "Expected a value");
+        (void) _;
+    }
+    assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 1);
+}
+
+static double f64Invalid(const double value) {
+    return value < 0 ? __builtin_nan("") : value;
+}
+
+static uint32_t indexNext(const uint32_t value) {
+    return value + 1;
+}
+
+Feature(NicheOption_size) {
+    assert_equal(sizeof(OptionF64), sizeof(double));
+    assert_equal(sizeof(OptionI64), sizeof(int64_t));
+    assert_equal(sizeof(OptionIndex), sizeof(uint32_t));
+    assert_equal(sizeof(OptionPort), sizeof(int));
+}
+
+Feature(NicheOption_some) {
+    assert_true(OptionF64_isSome(OptionF64_some(0.0)));
+    assert_true(OptionI64_isSome(OptionI64_some(INT64_MAX)));
+    assert_true(OptionIndex_isSome(OptionIndex_some(0)));
+    assert_equal(OPTION_UNWRAP(OptionPort, OptionPort_some(8080)), 8080);
+
+#if !defined(OPTION_UNCHECKED)
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+    traits_unit_wraps(SIGABRT) {
+        const OptionIndex _ = OptionIndex_some(UINT32_MAX);
+        (void) _;
+    }
+    assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 1);
+#endif
+}
+
+Feature(NicheOption_none) {
+    assert_true(OptionF64_isNone(OptionF64_none()));
+    assert_true(OptionI64_isNone(OptionI64_none()));
+    assert_true(OptionIndex_isNone(OptionIndex_none()));
+    assert_true(OptionPort_isNone(OptionPort_none()));
+}
+
+Feature(NicheOption_fromRaw) {
+    assert_true(OptionF64_isNone(OptionF64_fromRaw(__builtin_nan(""))));
+    assert_true(OptionF64_isNone(OptionF64_fromRaw(-__builtin_nan(""))));
+    assert_true(OptionF64_isSome(OptionF64_fromRaw(1.0)));
+    assert_true(OptionI64_isNone(OptionI64_fromRaw(INT64_MIN)));
+    assert_true(OptionPort_isNone(OptionPort_fromRaw(0)));
+    assert_true(OptionPort_isSome(OptionPort_fromRaw(22)));
+}
+
+Feature(NicheOption_map) {
+    {
+        const OptionF64 sut = OptionF64_map(OptionF64_some(-1), f64Invalid);
+        assert_true(OptionF64_isNone(sut));
+    }
+
+    {
+        const OptionF64 sut = OptionF64_map(OptionF64_some(1), f64Invalid);
+        assert_equal(OPTION_UNWRAP(OptionF64, sut), 1.0);
+    }
+
+    {
+        const OptionIndex sut = OptionIndex_map(OptionIndex_some(UINT32_MAX - 1), indexNext);
+        assert_true(OptionIndex_isNone(sut));
+    }
+
+    {
+        const OptionIndex sut = OptionIndex_alt(OptionIndex_map(OptionIndex_none(), indexNext), OptionIndex_some(3));
+        assert_equal(OPTION_UNWRAP(OptionIndex, sut), 3);
+    }
+}
@@ -29,6 +29,8 @@ OTHER DEALINGS IN THE SOFTWARE.
 #include <traits/traits.h>
 #include "features.h"
 
+const int digits[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
 Feature(None) {
     assert_true(Option_isNone(None));
     assert_false(Option_isSome(None));
@@ -39,12 +41,14 @@ Feature(Option_some) {
     assert_false(Option_isNone(sut));
     assert_true(Option_isSome(sut));
 
+#if !defined(OPTION_UNCHECKED)
     const size_t counter = traits_unit_get_wrapped_signals_counter();
     traits_unit_wraps(SIGABRT) {
         const Option _ = Option_some(NULL);
         (void) _;
     }
     assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 1);
+#endif
 }
 
 Feature(Option_fromNullable) {
@@ -183,6 +187,78 @@ Feature(Option_orElse) {
     }
 }
 
+const void *mapWithCounter(void *context, const void *value) {
+    size_t *counter = context;
+    *counter += 1;
+    return value;
+}
+
+Feature(Option_mapWith) {
+    size_t counter = 0;
+
+    {
+        const Option sut = Option_mapWith(None, mapWithCounter, &counter);
+        assert_true(Option_isNone(sut));
+        assert_equal(counter, 0);
+    }
+
+    {
+        const Option sut = Option_mapWith(Option_some("A"), mapWithCounter, &counter);
+        assert_true(Option_isSome(sut));
+        assert_string_equal(Option_unwrap(sut), "A");
+        assert_equal(counter, 1);
+    }
+
+    {
+        const Option sut = Option_mapWith(Option_some("A"), mapWithCounter, &counter);
+        assert_string_equal(Option_unwrap(sut), "A");
+        assert_equal(counter, 2);
+    }
+}
+
+Option chainWithLookup(void *context, const void *value) {
+    const char **table = context;
+    const char *key = value;
+    return Option_fromNullable(table[key[0] - 'A']);
+}
+
+Feature(Option_chainWith) {
+    const char *table[] = {"a", NULL};
+
+    {
+        const Option sut = Option_chainWith(None, chainWithLookup, table);
+        assert_true(Option_isNone(sut));
+    }
+
+    {
+        const Option sut = Option_chainWith(Option_some("A"), chainWithLookup, table);
+        assert_true(Option_isSome(sut));
+        assert_string_equal(Option_unwrap(sut), "a");
+    }
+
+    {
+        const Option sut = Option_chainWith(Option_some("B"), chainWithLookup, table);
+        assert_true(Option_isNone(sut));
+    }
+}
+
+Option orElseWithContext(void *context) {
+    return Option_some(context);
+}
+
+Feature(Option_orElseWith) {
+    {
+        const Option sut = Option_orElseWith(None, orElseWithContext, "X");
+        assert_true(Option_isSome(sut));
+        assert_string_equal(Option_unwrap(sut), "X");
+    }
+
+    {
+        const Option sut = Option_orElseWith(Option_some("A"), orElseWithContext, "X");
+        assert_string_equal(Option_unwrap(sut), "A");
+    }
+}
+
 Feature(Option_unwrap) {
     Option sut = Option_some("A");
 
@@ -238,3 +314,25 @@ Feature(Option_expectAsMutable) {
     }
     assert_equal(traits_unit_get_wrapped_signals_counter(), counter + 1);
 }
+
+Feature(Option_callSites) {
+    const OptionCallSite *sites = NULL;
+    const size_t count = Option_callSites(&sites);
+
+#if defined(__OPTION_CALL_SITES_TABLE)
+    // opaque to the optimizer, which would otherwise remove the failing branch together with its descriptor
+    const char *volatile value = "A";
+    const char *_ = Option_unwrap(Option_fromNullable(value));
+    const int line = __LINE__ - 1;
+    bool found = false;
+    (void) _;
+
+    assert_greater(count, 0);
+    for (size_t i = 0; i < count; i++) {
+        found |= line == OptionCallSite_line(&sites[i]) && NULL != strstr(OptionCallSite_file(&sites[i]), "features.c");
+    }
+    assert_true(found);
+#else
+    assert_equal(count, 0);
+#endif
+}
@@ -37,6 +37,11 @@ __attribute__(...)
 extern "C" {
 #endif
 
+/**
+ * The digits from 0 to 9, for the features wrapping values with stable addresses.
+ */
+extern const int digits[10];
+
 Feature(None);
 Feature(Option_some);
 Feature(Option_fromNullable);
@@ -44,10 +49,103 @@ Feature(Option_map);
 Feature(Option_chain);
 Feature(Option_alt);
 Feature(Option_orElse);
+Feature(Option_mapWith);
+Feature(Option_chainWith);
+Feature(Option_orElseWith);
 Feature(Option_unwrap);
 Feature(Option_unwrapAsMutable);
 Feature(Option_expect);
 Feature(Option_expectAsMutable);
+Feature(Option_callSites);
+
+Feature(TypedOption_some);
+Feature(TypedOption_none);
+Feature(TypedOption_map);
+Feature(TypedOption_chain);
+Feature(TypedOption_alt);
+Feature(TypedOption_orElse);
+Feature(TypedOption_unwrap);
+Feature(TypedOption_expect);
+
+Feature(NicheOption_size);
+Feature(NicheOption_some);
+Feature(NicheOption_none);
+Feature(NicheOption_fromRaw);
+Feature(NicheOption_map);
+
+Feature(OptionBatch_kernels);
+Feature(OptionBatch_countSome);
+Feature(OptionBatch_findNone);
+Feature(OptionBatch_maskSome);
+Feature(OptionBatch_compactSome);
+
+Feature(OptionVector_new);
+Feature(OptionVector_fromArray);
+Feature(OptionVector_set);
+Feature(OptionVector_map);
+Feature(OptionVector_filter);
+Feature(OptionVector_alt);
+
+Feature(OptionPipeline_new);
+Feature(OptionPipeline_run);
+Feature(OptionPipeline_runAll);
+Feature(OptionPipeline_noneCount);
+
+Feature(OptionArena_alloc);
+Feature(OptionArena_rewind);
+Feature(OptionArena_thread);
+Feature(OptionArena_map);
+Feature(OptionArena_chain);
+
+Feature(OptionSlab_alloc);
+Feature(OptionSlab_free);
+Feature(OptionSlab_threads);
+
+Feature(OptionIterator_new);
+Feature(OptionIterator_adaptors);
+Feature(OptionIterator_takeSkip);
+Feature(OptionIterator_zip);
+Feature(OptionIterator_fused);
+
+Feature(OptionPool_new);
+Feature(Option_parallelMap);
+Feature(Option_parallelChain);
+
+Feature(OptionPromise_fulfill);
+Feature(OptionPromise_wait);
+Feature(OptionPromise_then);
+
+Feature(AtomicOption_operations);
+Feature(AtomicOption_threads);
+Feature(OptionHazard_retire);
+
+Feature(OptionRcu_publish);
+Feature(OptionRcu_threads);
+
+Feature(OptionOnce_get);
+Feature(OptionOnce_threads);
+
+Feature(OptionMemo_call);
+Feature(OptionMemo_evict);
+Feature(OptionMemo_keys);
+
+Feature(OptionGeneric_map);
+Feature(OptionGeneric_chain);
+
+Feature(OptionHpp_some);
+Feature(OptionHpp_niche);
+Feature(OptionHpp_combinators);
+Feature(OptionHpp_interop);
+
+Feature(Panic_registerCallback);
+Feature(Panic_registerHook);
+Feature(Panic_unregisterHook);
+Feature(Panic_setReportSink);
+Feature(Panic_openReportSink);
+Feature(Panic_formatIntegers);
+Feature(Panic_formatDoubles);
+Feature(Panic_formatStrings);
+Feature(Panic_formatTruncation);
 
 #ifdef __cplusplus
 }